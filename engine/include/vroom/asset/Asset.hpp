@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <string>
 
@@ -15,6 +16,13 @@ public:
     [[nodiscard]] const std::filesystem::path& getPath() const { return m_path; }
     void setPath(const std::filesystem::path& path) { m_path = path; }
 
+    /**
+     * @brief Estimates the memory held by this asset, in bytes.
+     * Used by the AssetManager to enforce its cache budget. Assets owning large
+     * buffers should override this to include them.
+     */
+    [[nodiscard]] virtual size_t getMemoryUsage() const { return sizeof(*this); }
+
 protected:
     std::filesystem::path m_path;
 };
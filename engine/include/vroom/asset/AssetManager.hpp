@@ -2,22 +2,52 @@
 
 #include "vroom/asset/Asset.hpp"
 #include "vroom/asset/AssetProvider.hpp"
+#include "vroom/asset/AssetView.hpp"
 #include "vroom/asset/ShaderCompiler.hpp"
+#include "vroom/core/JobSystem.hpp"
 
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <list>
 #include <functional>
 #include <typeindex>
 #include <filesystem>
 #include <mutex>
+#include <shared_mutex>
+#include <future>
 #include <optional>
+#include <atomic>
+#include <cstdint>
 
 namespace vroom {
 
+/**
+ * @brief Counters describing AssetManager cache and load behaviour.
+ */
+struct AssetCacheStats {
+    uint64_t cacheHits = 0;         ///< Requests served straight from the cache
+    uint64_t loads = 0;             ///< Requests that read and decoded the asset
+    uint64_t failedLoads = 0;       ///< Loads that produced no asset
+    uint64_t coalescedRequests = 0; ///< Requests that joined an in-flight load of the same path
+    uint64_t evictions = 0;         ///< Assets dropped from the cache to stay within budget
+    size_t residentBytes = 0;       ///< Sum of Asset::getMemoryUsage() over cached assets
+    size_t residentAssets = 0;      ///< Number of cached assets
+};
+
 /**
  * @brief Manages asset loading, caching, and lifecycle.
+ *
+ * Reading and decoding happen outside the cache lock, so a slow asset only blocks
+ * the callers waiting for that asset. loadAssetAsync() runs loads on the job system set
+ * with setJobSystem(), or on a private one started on first use.
+ *
+ * Concurrent requests for the same path are coalesced: only the first one reads and
+ * decodes, the others wait for and share its result.
+ *
+ * The cache can be given a memory budget. When it is exceeded, least recently used
+ * assets that nobody else references and that are not pinned are evicted.
  */
 class AssetManager {
 public:
@@ -51,6 +81,17 @@ public:
      */
     ShaderCompiler* getShaderCompiler() const { return m_compiler.get(); }
 
+    /**
+     * @brief Sets the job system that async loads run on.
+     * @param jobs The job system, which must outlive this manager. nullptr reverts to a private one.
+     */
+    void setJobSystem(JobSystem* jobs);
+
+    /**
+     * @brief Gets the job system, starting a private one on first use if none was set.
+     */
+    JobSystem& getJobSystem();
+
     /**
      * @brief Loader function type.
      * Takes raw data and the path (for debugging/metadata), returns a shared_ptr to T.
@@ -58,47 +99,96 @@ public:
     template<typename T>
     using AssetLoader = std::function<std::shared_ptr<T>(const std::vector<char>&, const std::string&)>;
 
+    /**
+     * @brief Zero-copy loader function type.
+     * Takes a view over the provider's storage instead of an owned buffer. The view can be
+     * retained by the asset to keep referencing the bytes without copying them.
+     */
+    template<typename T>
+    using AssetViewLoader = std::function<std::shared_ptr<T>(const AssetView&, const std::string&)>;
+
     /**
      * @brief Registers a loader for a specific asset type.
+     * The raw data is copied into a buffer before being handed to the loader.
      * @tparam T The asset type.
      * @param loader The function to call to create the asset from raw data.
      */
     template<typename T>
     void registerLoader(AssetLoader<T> loader) {
-        m_loaders[std::type_index(typeid(T))] = [loader](const std::vector<char>& data, const std::string& path) -> std::shared_ptr<Asset> {
+        std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+        m_loaders[std::type_index(typeid(T))] = [loader](const AssetView& data, const std::string& path) -> std::shared_ptr<Asset> {
+            return loader(data.toVector(), path);
+        };
+    }
+
+    /**
+     * @brief Registers a zero-copy loader for a specific asset type.
+     * @tparam T The asset type.
+     * @param loader The function to call to create the asset from a view of the raw data.
+     */
+    template<typename T>
+    void registerLoader(AssetViewLoader<T> loader) {
+        std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+        m_loaders[std::type_index(typeid(T))] = [loader](const AssetView& data, const std::string& path) -> std::shared_ptr<Asset> {
             return loader(data, path);
         };
     }
 
     /**
      * @brief Loads an asset of type T.
+     * The cache lock is only held for the lookup and the final insert; the read and
+     * decode run unlocked.
      * @tparam T The type of asset to load (must inherit from Asset).
      * @param path The path to the asset relative to registered providers.
      * @return Shared pointer to the loaded asset, or nullptr if loading failed.
      */
     template<typename T>
     std::shared_ptr<T> getAsset(const std::string& path) {
-        std::lock_guard<std::mutex> lock(m_assetsMutex);
-        
-        auto it = m_assets.find(path);
-        if (it != m_assets.end()) {
-            return std::dynamic_pointer_cast<T>(it->second);
+        if (auto cached = findCached(path)) {
+            return std::dynamic_pointer_cast<T>(cached);
         }
+        return std::dynamic_pointer_cast<T>(loadAndCache(std::type_index(typeid(T)), path));
+    }
 
-        auto rawData = readRawAsset(path);
-        if (!rawData) {
-            return nullptr;
-        }
+    /**
+     * @brief Loads an asset of type T on the job system.
+     * Cached assets complete immediately without queuing a job.
+     * @tparam T The type of asset to load (must inherit from Asset).
+     * @param path The path to the asset relative to registered providers.
+     * @return Future holding the loaded asset, or nullptr if loading failed.
+     */
+    template<typename T>
+    std::future<std::shared_ptr<T>> loadAssetAsync(const std::string& path) {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<T>>>();
+        auto future = promise->get_future();
+        AssetCallback deliver = [promise](const std::shared_ptr<Asset>& asset) {
+            promise->set_value(std::dynamic_pointer_cast<T>(asset));
+        };
 
-        auto asset = loadFromRaw<T>(*rawData, path);
-        if (asset) {
-            asset->setPath(path);
-            m_assets[path] = asset;
+        // Joining an in-flight load registers a continuation instead of parking a worker on it
+        if (!resolveOrJoinPending(path, deliver)) {
+            getJobSystem().run([this, path, promise, deliver]() {
+                try {
+                    deliver(loadAndCache(std::type_index(typeid(T)), path));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            }, &m_asyncLoads);
         }
-        
-        return asset;
+        return future;
     }
 
+    /**
+     * @brief Compiles the GLSL sources of many ShaderAssets in one batch and caches the results.
+     * Meant for startup: rather than each shader compiling on its own as it is requested,
+     * every uncached source in paths goes to ShaderCompiler::compileBatch() on the job
+     * system together, and later getAsset<ShaderAsset>() calls are cache hits. Paths that
+     * are already cached, missing, or precompiled (.spv) are left to the regular loader.
+     * @param paths The shader source paths, as passed to getAsset().
+     * @return The number of shaders compiled and cached.
+     */
+    size_t preloadShaders(const std::vector<std::string>& paths);
+
     /**
      * @brief Reloads an asset, bypassing the cache.
      * Note: This replaces the asset in the cache. Existing shared_ptrs will still point to the old asset.
@@ -106,42 +196,112 @@ public:
      */
     template<typename T>
     std::shared_ptr<T> reloadAsset(const std::string& path) {
-        std::lock_guard<std::mutex> lock(m_assetsMutex);
-        
-        auto rawData = readRawAsset(path);
-        if (!rawData) {
-            return nullptr;
-        }
-
-        auto asset = loadFromRaw<T>(*rawData, path);
-        if (asset) {
-            asset->setPath(path);
-            m_assets[path] = asset;
-        }
-        
-        return asset;
+        return std::dynamic_pointer_cast<T>(loadAndCache(std::type_index(typeid(T)), path, true));
     }
 
+    /**
+     * @brief Sets the cache memory budget and evicts down to it.
+     * @param bytes Budget in bytes, as measured by Asset::getMemoryUsage(). 0 means unlimited.
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Gets the cache memory budget in bytes (0 means unlimited).
+     */
+    [[nodiscard]] size_t getMemoryBudget() const;
+
+    /**
+     * @brief Evicts unreferenced, unpinned assets until the cache fits its budget.
+     * Eviction also runs whenever an asset is cached; call this to reclaim assets
+     * whose last outside reference was dropped since then.
+     */
+    void trimCache();
+
+    /**
+     * @brief Keeps an asset resident regardless of the memory budget.
+     * Pins are counted and may be placed before the asset is loaded.
+     * @param path The asset path, as passed to getAsset().
+     */
+    void pinAsset(const std::string& path);
+
+    /**
+     * @brief Releases one pin placed by pinAsset().
+     */
+    void unpinAsset(const std::string& path);
+
+    /**
+     * @brief Gets a snapshot of the cache and load counters.
+     */
+    [[nodiscard]] AssetCacheStats getStats() const;
+
 private:
-    [[nodiscard]] std::optional<std::vector<char>> readRawAsset(const std::filesystem::path& path) const;
+    struct CacheEntry {
+        std::shared_ptr<Asset> asset;
+        size_t memoryUsage = 0;
+        std::list<std::string>::iterator lruPosition;
+    };
 
-    template<typename T>
-    std::shared_ptr<T> loadFromRaw(const std::vector<char>& data, const std::string& path) {
-        auto it = m_loaders.find(std::type_index(typeid(T)));
-        if (it != m_loaders.end()) {
-            auto asset = it->second(data, path);
-            return std::dynamic_pointer_cast<T>(asset);
-        }
-        return nullptr;
-    }
+    using AssetCallback = std::function<void(const std::shared_ptr<Asset>&)>;
+
+    struct PendingLoad {
+        std::shared_future<std::shared_ptr<Asset>> result;
+        std::vector<AssetCallback> continuations;
+    };
+
+    [[nodiscard]] std::optional<AssetView> readRawAsset(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Returns the cached asset for path and marks it most recently used, or nullptr.
+     */
+    [[nodiscard]] std::shared_ptr<Asset> findCached(const std::string& path);
+
+    // The helpers below expect m_assetsMutex to be held
+    std::shared_ptr<Asset> touchCached(const std::string& path);
+    std::shared_ptr<Asset> insertCached(const std::string& path, std::shared_ptr<Asset> asset, bool replace);
+    void eraseCached(std::unordered_map<std::string, CacheEntry>::iterator it);
+    void evictToBudget();
+
+    /**
+     * @brief Delivers a cached asset immediately, or queues the callback on an in-flight load.
+     * @return False if the asset is neither cached nor being loaded; the callback was not used.
+     */
+    bool resolveOrJoinPending(const std::string& path, const AssetCallback& callback);
+
+    /**
+     * @brief Reads and decodes an asset without holding the cache lock, then caches it.
+     * Unless replacing, callers racing on the same path wait for the first caller's load.
+     */
+    std::shared_ptr<Asset> loadAndCache(std::type_index type, const std::string& path, bool replace = false);
+
+    std::shared_ptr<Asset> loadUncached(std::type_index type, const std::string& path);
 
     std::vector<std::unique_ptr<AssetProvider>> m_providers;
-    std::unordered_map<std::string, std::shared_ptr<Asset>> m_assets;
+    std::unordered_map<std::string, CacheEntry> m_assets;
+    std::list<std::string> m_lru; // Most recently used first
+    std::unordered_map<std::string, uint32_t> m_pinCounts;
+    size_t m_memoryBudget = 0;
+    size_t m_residentBytes = 0;
+    std::unordered_map<std::string, PendingLoad> m_pendingLoads;
     mutable std::mutex m_assetsMutex;
+    // Bumped by clearProviders() so loads that started before a reset don't repopulate the cache
+    uint64_t m_cacheGeneration = 0;
     std::unique_ptr<ShaderCompiler> m_compiler;
 
-    using AnyLoader = std::function<std::shared_ptr<Asset>(const std::vector<char>&, const std::string&)>;
+    using AnyLoader = std::function<std::shared_ptr<Asset>(const AssetView&, const std::string&)>;
     std::unordered_map<std::type_index, AnyLoader> m_loaders;
+    // Guards m_providers and m_loaders, which workers read concurrently
+    mutable std::shared_mutex m_registryMutex;
+
+    std::atomic<uint64_t> m_cacheHits{0};
+    std::atomic<uint64_t> m_loads{0};
+    std::atomic<uint64_t> m_failedLoads{0};
+    std::atomic<uint64_t> m_coalescedRequests{0};
+    std::atomic<uint64_t> m_evictions{0};
+
+    std::mutex m_jobMutex;
+    JobSystem* m_jobSystem = nullptr;
+    std::unique_ptr<JobSystem> m_ownedJobSystem;
+    JobCounter m_asyncLoads;
 };
 
 } // namespace vroom
@@ -1,14 +1,20 @@
 #pragma once
 
+#include "vroom/asset/AssetView.hpp"
+
 #include <filesystem>
+#include <memory>
 #include <vector>
 #include <string>
 #include <fstream>
-#include <unordered_map>
+#include <span>
+#include <string_view>
+#include <cstdint>
 
 namespace vroom {
 
 struct PackageFileEntry; // Forward declaration
+struct PackageTocEntry;
 
 /**
  * @brief Interface for reading asset data from various sources (Disk, Archive).
@@ -22,6 +28,13 @@ public:
     
     // Returns the raw data of the asset
     [[nodiscard]] virtual std::vector<char> readFile(const std::filesystem::path& relativePath) const = 0;
+
+    // Returns a read-only view of the asset data.
+    // The default implementation wraps readFile(); providers that can expose their
+    // storage directly (e.g. memory-mapped packages) override this to avoid the copy.
+    [[nodiscard]] virtual AssetView viewFile(const std::filesystem::path& relativePath) const {
+        return AssetView(readFile(relativePath));
+    }
 };
 
 /**
@@ -38,24 +51,82 @@ private:
     std::filesystem::path m_rootPath;
 };
 
+class MappedFile;
+
+/**
+ * @brief How a PackageAssetProvider accesses the package contents.
+ */
+enum class PackageAccessMode {
+    Stream,       ///< Open, seek and read the package file for every asset.
+    MemoryMapped  ///< Map the package once and serve views straight out of the mapping.
+};
+
 /**
  * @brief Provider that reads assets from a package file (single file container).
- * @note Implementation details would depend on the package format.
+ *
+ * In MemoryMapped mode (the default) the package is mapped once at construction and
+ * viewFile() hands out views into the mapping without any syscall or copy. If the
+ * mapping cannot be established the provider falls back to Stream mode.
+ *
+ * Both package versions are mounted into the same sorted table of contents. For v2
+ * packages in MemoryMapped mode the table and path strings are used in place, so
+ * mounting performs no per-file allocation.
+ *
+ * Compressed entries are decompressed transparently by readFile() and viewFile().
  */
 class PackageAssetProvider : public AssetProvider {
 public:
-    explicit PackageAssetProvider(const std::filesystem::path& packagePath);
+    explicit PackageAssetProvider(const std::filesystem::path& packagePath,
+                                  PackageAccessMode mode = PackageAccessMode::MemoryMapped);
+    ~PackageAssetProvider() override;
     
     [[nodiscard]] bool exists(const std::filesystem::path& relativePath) const override;
     [[nodiscard]] std::vector<char> readFile(const std::filesystem::path& relativePath) const override;
+    [[nodiscard]] AssetView viewFile(const std::filesystem::path& relativePath) const override;
+
+    /**
+     * @brief Gets the access mode actually in use.
+     */
+    [[nodiscard]] PackageAccessMode getAccessMode() const {
+        return m_mapping ? PackageAccessMode::MemoryMapped : PackageAccessMode::Stream;
+    }
+
+    /**
+     * @brief Gets the format version of the mounted package, or 0 if mounting failed.
+     */
+    [[nodiscard]] uint32_t getVersion() const { return m_version; }
+
+    /**
+     * @brief Gets the number of files in the package.
+     */
+    [[nodiscard]] size_t getFileCount() const;
+
+    /**
+     * @brief Recomputes every entry's checksum and compares it against the table of contents.
+     * Only v2 packages carry checksums; v1 packages always verify successfully.
+     * @return True if all entries match.
+     */
+    [[nodiscard]] bool verifyChecksums() const;
 
 private:
+    bool readAt(uint64_t offset, void* destination, uint64_t size) const;
+    bool mountV1(uint32_t fileCount);
+    bool mountV2();
+    [[nodiscard]] const PackageTocEntry* findEntry(const std::filesystem::path& relativePath) const;
+    [[nodiscard]] std::vector<char> readCompressed(const PackageTocEntry& entry) const;
+    [[nodiscard]] std::string_view entryPath(const PackageTocEntry& entry) const;
+
     std::filesystem::path m_packagePath;
-    struct FileInfo {
-        uint64_t offset;
-        uint64_t size;
-    };
-    std::unordered_map<std::string, FileInfo> m_fileTable;
+    std::shared_ptr<const MappedFile> m_mapping;
+    uint64_t m_packageSize = 0;
+    uint32_t m_version = 0;
+
+    // Sorted table of contents and path blob. These point either into the mapping or
+    // into the owned storage below (stream mode, v1 packages, misaligned tables).
+    std::span<const PackageTocEntry> m_toc;
+    std::string_view m_strings;
+    std::vector<PackageTocEntry> m_tocStorage;
+    std::vector<char> m_stringStorage;
 };
 
 } // namespace vroom
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace vroom {
+
+/**
+ * @brief Read-only view over the raw bytes of an asset.
+ *
+ * The view does not own the bytes directly; it shares ownership of whatever
+ * backs them (a memory-mapped package, or a heap buffer) so the data stays
+ * valid for as long as any copy of the view is alive.
+ */
+class AssetView {
+public:
+    AssetView() = default;
+
+    /**
+     * @brief Creates a view over memory kept alive by an owner handle.
+     * @param data The bytes to expose.
+     * @param owner Handle keeping the bytes alive.
+     */
+    AssetView(std::span<const char> data, std::shared_ptr<const void> owner)
+        : m_data(data), m_owner(std::move(owner)) {}
+
+    /**
+     * @brief Creates a view that takes ownership of a heap buffer.
+     * @param buffer The buffer to expose.
+     */
+    explicit AssetView(std::vector<char> buffer) {
+        auto owned = std::make_shared<const std::vector<char>>(std::move(buffer));
+        m_data = std::span<const char>(owned->data(), owned->size());
+        m_owner = std::move(owned);
+    }
+
+    [[nodiscard]] const char* data() const { return m_data.data(); }
+    [[nodiscard]] size_t size() const { return m_data.size(); }
+    [[nodiscard]] bool empty() const { return m_data.empty(); }
+
+    [[nodiscard]] const char* begin() const { return m_data.data(); }
+    [[nodiscard]] const char* end() const { return m_data.data() + m_data.size(); }
+
+    [[nodiscard]] std::span<const char> span() const { return m_data; }
+
+    /**
+     * @brief Copies the viewed bytes into a new buffer.
+     */
+    [[nodiscard]] std::vector<char> toVector() const { return {begin(), end()}; }
+
+private:
+    std::span<const char> m_data;
+    std::shared_ptr<const void> m_owner;
+};
+
+} // namespace vroom
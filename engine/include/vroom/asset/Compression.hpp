@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vroom {
+
+/**
+ * @brief Compression codecs supported for package entries.
+ */
+enum class PackageCodec : uint32_t {
+    None = 0, ///< Stored raw.
+    LZ4 = 1   ///< LZ4 block format (no frame header).
+};
+
+/**
+ * @brief Worst-case compressed size for an input of the given size.
+ */
+constexpr size_t lz4CompressBound(size_t inputSize) {
+    return inputSize + inputSize / 255 + 16;
+}
+
+/**
+ * @brief Compresses a buffer into the LZ4 block format.
+ *
+ * The output is readable by any standard LZ4 block decoder.
+ * @param source Input bytes.
+ * @param sourceSize Number of input bytes.
+ * @param destination Output buffer.
+ * @param destinationCapacity Size of the output buffer.
+ * @return The compressed size, or 0 if the output did not fit in destinationCapacity.
+ */
+size_t lz4Compress(const char* source, size_t sourceSize, char* destination, size_t destinationCapacity);
+
+/**
+ * @brief Decompresses an LZ4 block whose decompressed size is known up front.
+ *
+ * The decoder is bounds-checked against both buffers, so corrupt input fails
+ * cleanly instead of reading or writing out of range.
+ * @param source Compressed bytes.
+ * @param sourceSize Number of compressed bytes.
+ * @param destination Output buffer, exactly destinationSize bytes long.
+ * @param destinationSize Expected decompressed size.
+ * @return True if the block decoded to exactly destinationSize bytes.
+ */
+bool lz4Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize);
+
+} // namespace vroom
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+namespace vroom {
+
+/**
+ * @brief Read-only memory mapping of an entire file.
+ *
+ * The mapping is established on construction and released on destruction.
+ * Share it through a std::shared_ptr to hand out views that outlive the owner.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    // Prevent copying
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Returns true if the file was mapped successfully.
+     */
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+
+    [[nodiscard]] const char* data() const { return m_data; }
+    [[nodiscard]] size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+#if defined(_WIN32)
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+} // namespace vroom
@@ -1,26 +1,103 @@
 #pragma once
 
 #include "vroom/asset/AssetProvider.hpp"
+#include "vroom/asset/Compression.hpp"
+#include "vroom/core/Hash.hpp"
 #include "vroom/logging/LogMacros.hpp"
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <filesystem>
+#include <cstdint>
 
 namespace vroom {
 
+constexpr uint32_t PACKAGE_VERSION_1 = 1;
+constexpr uint32_t PACKAGE_VERSION_2 = 2;
+
+// Data blobs in a v2 package start on this boundary, so views into a mapped
+// package are suitably aligned for SPIR-V and other word-based formats.
+constexpr uint32_t PACKAGE_DATA_ALIGNMENT = 16;
+
+/**
+ * @brief Common header prefix shared by every package version.
+ */
 struct PackageHeader {
     char magic[4] = {'V', 'R', 'P', 'K'}; // VRoom PacKage
-    uint32_t version = 1;
+    uint32_t version = PACKAGE_VERSION_1;
     uint32_t fileCount = 0;
 };
 
+/**
+ * @brief Version 1 file entry: a fixed-size path followed by the data location.
+ * Entries follow the header directly and are unsorted.
+ */
 struct PackageFileEntry {
     char path[256]; // Fixed size path for simplicity
     uint64_t offset;
     uint64_t size;
 };
 
-} // namespace vroom
+/**
+ * @brief Version 2 header.
+ *
+ * Layout: header, table of contents, string blob, then the file data. The TOC is
+ * sorted by (pathHash, path) so it can be binary-searched directly out of a
+ * mapped package without building any lookup structure.
+ */
+struct PackageHeaderV2 {
+    char magic[4] = {'V', 'R', 'P', 'K'};
+    uint32_t version = PACKAGE_VERSION_2;
+    uint32_t fileCount = 0;
+    uint32_t dataAlignment = PACKAGE_DATA_ALIGNMENT;
+    uint64_t tocOffset = 0;
+    uint64_t stringTableOffset = 0;
+    uint64_t stringTableSize = 0;
+};
 
+/**
+ * @brief Version 2 table of contents entry.
+ * The path lives in the string blob (not null-terminated) at pathOffset.
+ * Compressed entries occupy storedSize bytes on disk and expand to exactly size bytes.
+ */
+struct PackageTocEntry {
+    uint64_t pathHash;
+    uint64_t offset;
+    uint64_t storedSize; // Bytes on disk
+    uint64_t size;       // Bytes after decompression
+    uint64_t checksum;   // hashPackageData() of the stored bytes
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    PackageCodec codec;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(PackageHeader) == 12, "PackageHeader layout is part of the file format");
+static_assert(sizeof(PackageFileEntry) == 272, "PackageFileEntry layout is part of the file format");
+static_assert(sizeof(PackageHeaderV2) == 40, "PackageHeaderV2 layout is part of the file format");
+static_assert(sizeof(PackageTocEntry) == 56, "PackageTocEntry layout is part of the file format");
+
+/**
+ * @brief 64-bit FNV-1a hash used for package path lookup and entry checksums.
+ */
+constexpr uint64_t hashPackageData(const char* data, size_t size) {
+    return hashBytes(data, size);
+}
+
+/**
+ * @brief Hashes a package-relative path. Paths are stored with '/' separators.
+ */
+constexpr uint64_t hashPackagePath(std::string_view path) {
+    return hashPackageData(path.data(), path.size());
+}
+
+/**
+ * @brief Rounds an offset up to the next multiple of alignment (a power of two).
+ */
+constexpr uint64_t alignPackageOffset(uint64_t offset, uint64_t alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace vroom
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "vroom/asset/Asset.hpp"
+#include "vroom/asset/AssetView.hpp"
+#include <filesystem>
 #include <vector>
 #include <string>
 
@@ -19,20 +21,42 @@ enum class ShaderStage {
     Unknown
 };
 
+/**
+ * @brief Deduces a shader's stage from its file extension (shader.vert, shader.frag.spv, ...).
+ * @return The stage, or ShaderStage::Unknown for unrecognised extensions.
+ */
+inline ShaderStage shaderStageFromPath(const std::filesystem::path& path) {
+    // Precompiled binaries follow the naming convention shader.vert.spv
+    std::string ext = path.extension() == ".spv" ? path.stem().extension().string() : path.extension().string();
+    if (ext == ".vert" || ext == ".vs") return ShaderStage::Vertex;
+    if (ext == ".frag" || ext == ".fs") return ShaderStage::Fragment;
+    if (ext == ".comp") return ShaderStage::Compute;
+    if (ext == ".geom") return ShaderStage::Geometry;
+    if (ext == ".tesc") return ShaderStage::TessellationControl;
+    if (ext == ".tese") return ShaderStage::TessellationEvaluation;
+    return ShaderStage::Unknown;
+}
+
 /**
  * @brief Asset representing a compiled shader.
- * Holds the SPIR-V binary data.
+ * Holds the SPIR-V binary data, either in an owned buffer or as a view
+ * directly into the provider's storage (e.g. a memory-mapped package).
  */
 class ShaderAsset : public Asset {
 public:
     ShaderAsset(std::vector<char> data, ShaderStage stage)
         : m_data(std::move(data)), m_stage(stage) {}
 
-    [[nodiscard]] const std::vector<char>& getData() const { return m_data; }
+    ShaderAsset(AssetView data, ShaderStage stage)
+        : m_data(std::move(data)), m_stage(stage) {}
+
+    [[nodiscard]] const AssetView& getData() const { return m_data; }
     [[nodiscard]] ShaderStage getStage() const { return m_stage; }
 
+    [[nodiscard]] size_t getMemoryUsage() const override { return sizeof(*this) + m_data.size(); }
+
 private:
-    std::vector<char> m_data;
+    AssetView m_data;
     ShaderStage m_stage;
 };
 
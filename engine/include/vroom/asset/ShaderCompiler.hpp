@@ -2,13 +2,39 @@
 
 #include "vroom/asset/ShaderAsset.hpp"
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace vroom {
 
+class JobSystem;
+
+/**
+ * @brief A single shader to compile as part of a batch.
+ */
+struct ShaderCompileJob {
+    std::filesystem::path sourcePath;
+    std::string sourceCode;
+    ShaderStage stage = ShaderStage::Unknown;
+};
+
+/**
+ * @brief Outcome of compiling one shader.
+ */
+struct ShaderCompileResult {
+    std::optional<std::vector<char>> binary; // nullopt if compilation failed
+    std::string diagnostics;                 // Errors and warnings reported by the compiler
+
+    [[nodiscard]] bool succeeded() const { return binary.has_value(); }
+};
+
 /**
  * @brief Interface for compiling shaders at runtime.
+ * Implementations must allow compile() to be called from several threads at once,
+ * as compileBatch() does.
  */
 class ShaderCompiler {
 public:
@@ -26,6 +52,39 @@ public:
         const std::string& sourceCode,
         ShaderStage stage
     ) = 0;
+
+    /**
+     * @brief Describes the compiler version and any options that affect its output.
+     * Cached binaries are only reused by a compiler reporting the same identity.
+     */
+    [[nodiscard]] virtual std::string getIdentity() const { return {}; }
+
+    /**
+     * @brief Compiles a shader and returns the compiler's diagnostics instead of logging them.
+     * The default implementation forwards to compile() and reports a generic failure message.
+     */
+    [[nodiscard]] virtual ShaderCompileResult compileWithDiagnostics(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    );
+
+    /**
+     * @brief Compiles many shaders in parallel.
+     * @param jobs The shaders to compile.
+     * @param jobSystem The job system the compiles are spread across, usually the engine's.
+     * @return One result per job, in the same order as jobs.
+     */
+    [[nodiscard]] virtual std::vector<ShaderCompileResult> compileBatch(
+        const std::vector<ShaderCompileJob>& jobs,
+        JobSystem& jobSystem
+    );
+
+protected:
+    /**
+     * @brief Logs a result's diagnostics and returns its binary; the usual body of compile().
+     */
+    std::optional<std::vector<char>> reportResult(const std::filesystem::path& sourcePath, ShaderCompileResult result) const;
 };
 
 /**
@@ -41,6 +100,113 @@ public:
         const std::string& sourceCode,
         ShaderStage stage
     ) override;
+
+    [[nodiscard]] ShaderCompileResult compileWithDiagnostics(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    ) override;
+
+    /**
+     * @brief Returns the options passed to glslc that affect its output, and its `--version` banner.
+     * The version is queried once, on first use.
+     */
+    [[nodiscard]] std::string getIdentity() const override;
+
+private:
+    mutable std::once_flag m_identityOnce;
+    mutable std::string m_identity;
+};
+
+#if defined(VROOM_WITH_SHADERC)
+/**
+ * @brief Implementation of ShaderCompiler that compiles in-process with the shaderc library.
+ * No processes are spawned and no temporary files are written. compile() may be called
+ * from several threads at once.
+ */
+class ShadercShaderCompiler : public ShaderCompiler {
+public:
+    ShadercShaderCompiler();
+    ~ShadercShaderCompiler() override;
+
+    ShadercShaderCompiler(const ShadercShaderCompiler&) = delete;
+    ShadercShaderCompiler& operator=(const ShadercShaderCompiler&) = delete;
+
+    [[nodiscard]] std::optional<std::vector<char>> compile(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    ) override;
+
+    [[nodiscard]] ShaderCompileResult compileWithDiagnostics(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    ) override;
+
+    [[nodiscard]] std::string getIdentity() const override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+#endif
+
+/**
+ * @brief Content-addressed on-disk cache in front of another ShaderCompiler.
+ *
+ * Binaries are stored under the cache directory, named by a hash of the source text,
+ * the stage and the wrapped compiler's identity. Unchanged shaders are loaded
+ * straight from disk on later runs, and only edited ones reach the real compiler.
+ * Stale entries are never hit again and can be deleted at any time.
+ */
+class CachingShaderCompiler : public ShaderCompiler {
+public:
+    /**
+     * @param compiler The compiler used on a cache miss.
+     * @param cacheDirectory Directory holding cached binaries, created on demand.
+     */
+    CachingShaderCompiler(std::unique_ptr<ShaderCompiler> compiler, std::filesystem::path cacheDirectory);
+
+    [[nodiscard]] std::optional<std::vector<char>> compile(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    ) override;
+
+    [[nodiscard]] ShaderCompileResult compileWithDiagnostics(
+        const std::filesystem::path& sourcePath,
+        const std::string& sourceCode,
+        ShaderStage stage
+    ) override;
+
+    /**
+     * @brief Serves cached jobs from disk and forwards only the misses, as one batch,
+     * to the wrapped compiler.
+     */
+    [[nodiscard]] std::vector<ShaderCompileResult> compileBatch(
+        const std::vector<ShaderCompileJob>& jobs,
+        JobSystem& jobSystem
+    ) override;
+
+    [[nodiscard]] std::string getIdentity() const override { return m_compiler->getIdentity(); }
+
+    /**
+     * @brief Gets the file a given source and stage would be cached in.
+     */
+    [[nodiscard]] std::filesystem::path getCachePath(const std::string& sourceCode, ShaderStage stage) const;
+
+    [[nodiscard]] const std::filesystem::path& getCacheDirectory() const { return m_cacheDirectory; }
+    [[nodiscard]] ShaderCompiler& getCompiler() const { return *m_compiler; }
+
+private:
+    [[nodiscard]] std::optional<std::vector<char>> readCacheEntry(const std::filesystem::path& path) const;
+    void writeCacheEntry(const std::filesystem::path& path, const std::vector<char>& binary) const;
+
+    std::unique_ptr<ShaderCompiler> m_compiler;
+    std::filesystem::path m_cacheDirectory;
+    // Identity is fixed for the compiler's lifetime, so it is folded into keys only once
+    std::string m_identity;
 };
 
 } // namespace vroom
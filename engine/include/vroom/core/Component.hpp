@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
 
 namespace vroom {
 
@@ -34,12 +35,28 @@ public:
     class SceneManager* getSceneManager() const;
 
     // Internal use for the engine to mark start as called
-    void markStarted() { m_hasStarted = true; }
+    void markStarted();
+
+    // Internal use for the entity to flag components whose type overrides update()
+    void markUpdatable() { m_updatable = true; }
+    bool isUpdatable() const { return m_updatable; }
 
 protected:
     Entity* m_entity = nullptr;
     bool m_enabled = true;
     bool m_hasStarted = false;
+    bool m_updatable = false;
 };
 
+/// \brief Checks whether component type T, or a base of it, overrides Component::update().
+///
+/// Entities only call update() on components of such types, so components that only hold
+/// data cost nothing per frame.
+template <typename T>
+constexpr bool overridesUpdate() {
+    static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+    // &T::update names the most derived declaration, so its class is Component unless overridden
+    return !std::is_same_v<decltype(&T::update), void (Component::*)(float)>;
+}
+
 } // namespace vroom
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/Entity.hpp"
+#include "vroom/core/Scene.hpp"
+
+namespace vroom {
+
+/// \brief Type-erased save and load functions of one serializable component type.
+struct ComponentTypeInfo {
+    /// \brief Name the type is saved under, which must stay the same across versions.
+    std::string name;
+
+    /// \brief Size of the type's saved data, identical for every component.
+    uint32_t dataSize = 0;
+
+    /// \brief Appends the owner and the saved data of every component of the type in a scene.
+    /// Components of destroyed entities are left out.
+    std::function<void(Scene& scene, std::vector<Entity*>& owners, std::vector<char>& data)> save;
+
+    /// \brief Adds a component to each of count entities, from count packed data values.
+    std::function<void(Entity* const* entities, const char* data, size_t count)> load;
+
+    /// \brief Converts one data value to JSON.
+    std::function<nlohmann::json(const char* data)> toJson;
+
+    /// \brief Converts JSON to one data value of dataSize bytes. Throws nlohmann::json::exception on bad input.
+    std::function<void(const nlohmann::json& json, char* data)> fromJson;
+};
+
+/// \brief The component types a SceneSerializer can save and load, looked up by name.
+///
+/// Components are not written out as they are in memory: they have vtables and pointers
+/// into their entity and scene. Each type instead names a plain data struct holding what
+/// it saves, and two functions to extract it from and apply it to a component. Data
+/// structs are trivially copyable, so a type's values go to and from a file as a single
+/// block, and convert to JSON with the to_json/from_json functions nlohmann finds for them.
+class ComponentRegistry {
+public:
+    ComponentRegistry() = default;
+
+    /// \brief Registers the engine's own serializable components (Transform).
+    void registerBuiltins();
+
+    /// \brief Registers a component type, replacing any type registered under the same name.
+    /// \tparam T The component type, which must be default-constructible.
+    /// \tparam Data Trivially copyable struct holding what is saved of a T.
+    /// \param name Name the type is saved under.
+    /// \param save Callable returning the Data of a const T&.
+    /// \param load Callable applying a const Data& to a T&, just added to its entity.
+    template <typename T, typename Data, typename Save, typename Load>
+    void registerType(std::string name, Save save, Load load) {
+        static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+        static_assert(std::is_trivially_copyable_v<Data>, "Data is copied as raw bytes and must be trivially copyable");
+        static_assert(std::is_default_constructible_v<Data>, "Data must be default-constructible");
+
+        ComponentTypeInfo info;
+        info.name = std::move(name);
+        info.dataSize = static_cast<uint32_t>(sizeof(Data));
+        info.save = [save](Scene& scene, std::vector<Entity*>& owners, std::vector<char>& data) {
+            scene.forEachComponent<T>([&](T& component) {
+                Entity* owner = component.getEntity();
+                if (owner->isDestroyed()) {
+                    return;
+                }
+                owners.push_back(owner);
+                Data value = save(static_cast<const T&>(component));
+                data.resize(data.size() + sizeof(Data));
+                std::memcpy(data.data() + data.size() - sizeof(Data), &value, sizeof(Data));
+            });
+        };
+        info.load = [load](Entity* const* entities, const char* data, size_t count) {
+            // One copy out of the file for the whole type, also fixing up the alignment
+            std::vector<Data> values(count);
+            std::memcpy(values.data(), data, count * sizeof(Data));
+            for (size_t i = 0; i < count; ++i) {
+                load(entities[i]->addComponent<T>(), static_cast<const Data&>(values[i]));
+            }
+        };
+        info.toJson = [](const char* data) {
+            Data value;
+            std::memcpy(&value, data, sizeof(Data));
+            return nlohmann::json(value);
+        };
+        info.fromJson = [](const nlohmann::json& json, char* data) {
+            Data value = json.get<Data>();
+            std::memcpy(data, &value, sizeof(Data));
+        };
+        add(std::move(info));
+    }
+
+    /// \brief Finds a type by the name it is saved under.
+    /// \return The type, or nullptr if none is registered under name.
+    const ComponentTypeInfo* find(std::string_view name) const;
+
+    /// \brief Gets every registered type, in registration order.
+    const std::vector<ComponentTypeInfo>& getTypes() const { return m_types; }
+
+private:
+    void add(ComponentTypeInfo info);
+
+    std::vector<ComponentTypeInfo> m_types;
+};
+
+} // namespace vroom
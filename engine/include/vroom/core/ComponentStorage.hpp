@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/ComponentType.hpp"
+
+namespace vroom {
+
+/// \brief Type-erased interface of a ComponentPool, used to release components without knowing their type.
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase() = default;
+
+    /// \brief Destroys a component previously created by this pool and frees its slot.
+    /// \param component The component.
+    /// \param slot The slot create() placed it in.
+    virtual void destroy(Component* component, size_t slot) = 0;
+
+    /// \brief Gets the number of live components in the pool.
+    size_t size() const { return m_size; }
+
+protected:
+    size_t m_size = 0;
+};
+
+/// \brief Deleter for components owned by an Entity.
+///
+/// Components created through a ComponentStorage are handed back to their pool, others
+/// (entities that are not part of a scene) are deleted normally. The deleter remembers the
+/// component's slot, so freeing it does not have to search the pool.
+struct ComponentDeleter {
+    ComponentPoolBase* pool = nullptr;
+    size_t slot = 0;
+
+    void operator()(Component* component) const {
+        if (pool) {
+            pool->destroy(component, slot);
+        } else {
+            delete component;
+        }
+    }
+};
+
+using ComponentPtr = std::unique_ptr<Component, ComponentDeleter>;
+
+/// \brief Stores every component of one concrete type in fixed-size chunks.
+///
+/// Components are constructed in place and never move, so references handed out stay
+/// valid until the component is destroyed. Freed slots are reused by later allocations,
+/// keeping the live components packed into as few chunks as possible.
+/// \tparam T The concrete component type.
+template <typename T>
+class ComponentPool final : public ComponentPoolBase {
+public:
+    /// \brief Number of components per chunk, sized to roughly 16 KiB.
+    static constexpr size_t ChunkCapacity = std::max<size_t>(1, 16384 / sizeof(T));
+
+    ComponentPool() = default;
+
+    ~ComponentPool() override {
+        forEach([](T& component) { component.~T(); });
+    }
+
+    // Components hold their address in the pool, so the pool itself stays put
+    ComponentPool(const ComponentPool&) = delete;
+    ComponentPool& operator=(const ComponentPool&) = delete;
+
+    /// \brief Constructs a component in the first free slot.
+    /// \param slot Receives the slot to pass to destroy().
+    /// \param args Arguments forwarded to the component's constructor.
+    /// \return Pointer to the new component.
+    template <typename... Args>
+    T* create(size_t& slot, Args&&... args) {
+        if (m_freeSlots.empty()) {
+            addChunk();
+        }
+
+        slot = m_freeSlots.back();
+        Chunk& chunk = *m_chunks[slot / ChunkCapacity];
+        size_t index = slot % ChunkCapacity;
+
+        // Claim the slot only once construction succeeded
+        T* component = new (chunk.slot(index)) T(std::forward<Args>(args)...);
+        m_freeSlots.pop_back();
+        chunk.alive[index] = true;
+        ++m_size;
+        return component;
+    }
+
+    void destroy(Component* component, size_t slot) override {
+        static_cast<T*>(component)->~T();
+        m_chunks[slot / ChunkCapacity]->alive[slot % ChunkCapacity] = false;
+        m_freeSlots.push_back(slot);
+        --m_size;
+    }
+
+    /// \brief Visits every live component, walking the chunks in memory order.
+    /// \param fn Callable invoked with a T& for each component.
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (auto& chunk : m_chunks) {
+            for (size_t i = 0; i < ChunkCapacity; ++i) {
+                if (chunk->alive[i]) {
+                    fn(*chunk->slot(i));
+                }
+            }
+        }
+    }
+
+    /// \brief Gets the number of chunks allocated so far.
+    size_t getChunkCount() const { return m_chunks.size(); }
+
+private:
+    struct Chunk {
+        alignas(T) std::byte storage[sizeof(T) * ChunkCapacity];
+        std::array<bool, ChunkCapacity> alive{};
+
+        T* slot(size_t index) { return std::launder(reinterpret_cast<T*>(storage)) + index; }
+    };
+
+    void addChunk() {
+        size_t base = m_chunks.size() * ChunkCapacity;
+        m_chunks.push_back(std::make_unique<Chunk>());
+        // Pushed in reverse so the lowest slot is handed out first
+        for (size_t i = ChunkCapacity; i > 0; --i) {
+            m_freeSlots.push_back(base + i - 1);
+        }
+    }
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<size_t> m_freeSlots;
+};
+
+/// \brief Owns one ComponentPool per component type used in a Scene.
+///
+/// Components of the same type are allocated next to each other, so systems that touch
+/// one type across many entities walk memory linearly instead of chasing heap pointers.
+class ComponentStorage {
+public:
+    ComponentStorage() = default;
+
+    ComponentStorage(const ComponentStorage&) = delete;
+    ComponentStorage& operator=(const ComponentStorage&) = delete;
+
+    /// \brief Constructs a component of type T in its pool.
+    /// \return Owning pointer that returns the component to the pool when released.
+    template <typename T, typename... Args>
+    std::unique_ptr<T, ComponentDeleter> create(Args&&... args) {
+        auto& pool = getPool<T>();
+        size_t slot;
+        T* component = pool.create(slot, std::forward<Args>(args)...);
+        return std::unique_ptr<T, ComponentDeleter>(component, ComponentDeleter{&pool, slot});
+    }
+
+    /// \brief Gets the pool for type T, creating it on first use.
+    template <typename T>
+    ComponentPool<T>& getPool() {
+        ComponentTypeId type = componentTypeId<T>();
+        if (type >= m_pools.size()) {
+            m_pools.resize(type + 1);
+        }
+        auto& pool = m_pools[type];
+        if (!pool) {
+            pool = std::make_unique<ComponentPool<T>>();
+        }
+        return static_cast<ComponentPool<T>&>(*pool);
+    }
+
+    /// \brief Gets the pool for type T, or nullptr if no T was ever created.
+    template <typename T>
+    ComponentPool<T>* findPool() {
+        ComponentTypeId type = componentTypeId<T>();
+        return type < m_pools.size() ? static_cast<ComponentPool<T>*>(m_pools[type].get()) : nullptr;
+    }
+
+private:
+    std::vector<std::unique_ptr<ComponentPoolBase>> m_pools; // Indexed by ComponentTypeId
+};
+
+} // namespace vroom
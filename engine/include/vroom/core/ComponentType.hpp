@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace vroom {
+
+class Component;
+
+/// \brief Dense integer identifying a concrete component type, assigned on first use.
+using ComponentTypeId = uint32_t;
+
+/// \brief Number of component types tracked by ComponentMask.
+/// Types with higher IDs still work, they are just found by binary search instead of a bit test.
+constexpr ComponentTypeId MaxMaskedComponentTypes = 128;
+
+/// \brief Fixed-size bit set of component type IDs below MaxMaskedComponentTypes.
+class ComponentMask {
+public:
+    static constexpr size_t WordCount = MaxMaskedComponentTypes / 64;
+
+    /// \brief Checks whether a type ID can be stored in a mask.
+    static constexpr bool covers(ComponentTypeId id) { return id < MaxMaskedComponentTypes; }
+
+    void set(ComponentTypeId id) { m_words[id / 64] |= bit(id); }
+    void reset(ComponentTypeId id) { m_words[id / 64] &= ~bit(id); }
+    bool test(ComponentTypeId id) const { return (m_words[id / 64] & bit(id)) != 0; }
+
+    /// \brief Checks whether every type in other is also in this mask.
+    bool contains(const ComponentMask& other) const {
+        for (size_t i = 0; i < WordCount; ++i) {
+            if ((m_words[i] & other.m_words[i]) != other.m_words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool any() const {
+        for (uint64_t word : m_words) {
+            if (word != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// \brief Gets the lowest type ID in the mask. The mask must not be empty.
+    ComponentTypeId lowest() const {
+        for (size_t i = 0; i < WordCount; ++i) {
+            if (m_words[i] != 0) {
+                return static_cast<ComponentTypeId>(i * 64 + std::countr_zero(m_words[i]));
+            }
+        }
+        return MaxMaskedComponentTypes;
+    }
+
+    /// \brief Counts the type IDs in the mask that are lower than id.
+    size_t countBelow(ComponentTypeId id) const {
+        size_t count = 0;
+        for (size_t i = 0; i < id / 64; ++i) {
+            count += std::popcount(m_words[i]);
+        }
+        return count + std::popcount(m_words[id / 64] & (bit(id) - 1));
+    }
+
+    /// \brief Calls fn with each type ID in the mask, in ascending order.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < WordCount; ++i) {
+            for (uint64_t word = m_words[i]; word != 0; word &= word - 1) {
+                fn(static_cast<ComponentTypeId>(i * 64 + std::countr_zero(word)));
+            }
+        }
+    }
+
+    ComponentMask operator&(const ComponentMask& other) const {
+        ComponentMask result;
+        for (size_t i = 0; i < WordCount; ++i) {
+            result.m_words[i] = m_words[i] & other.m_words[i];
+        }
+        return result;
+    }
+
+    ComponentMask operator|(const ComponentMask& other) const {
+        ComponentMask result;
+        for (size_t i = 0; i < WordCount; ++i) {
+            result.m_words[i] = m_words[i] | other.m_words[i];
+        }
+        return result;
+    }
+
+    ComponentMask operator~() const {
+        ComponentMask result;
+        for (size_t i = 0; i < WordCount; ++i) {
+            result.m_words[i] = ~m_words[i];
+        }
+        return result;
+    }
+
+    bool operator==(const ComponentMask& other) const = default;
+
+    const uint64_t* words() const { return m_words; }
+    uint64_t* words() { return m_words; }
+
+private:
+    static constexpr uint64_t bit(ComponentTypeId id) { return uint64_t{1} << (id % 64); }
+
+    uint64_t m_words[WordCount] = {};
+};
+
+namespace detail {
+/// \brief Hands out the next unused component type ID. Thread-safe.
+ComponentTypeId nextComponentTypeId();
+} // namespace detail
+
+/// \brief Gets the ID of component type T.
+///
+/// IDs are assigned in order of first use, so they are stable within a run but not across runs.
+template <typename T>
+ComponentTypeId componentTypeId() {
+    static const ComponentTypeId id = detail::nextComponentTypeId();
+    return id;
+}
+
+/// \brief Remembers which component types derive from T.
+///
+/// Looking up a component by a base class needs to know whether each stored type is a T.
+/// The answer is found with one dynamic_cast per pair of types and cached here, so later
+/// lookups are mask operations.
+template <typename T>
+class DerivedComponentTypes {
+public:
+    /// \brief Checks whether the component type id derives from T (or is T).
+    /// \param instance A component of that type, used to answer the first query.
+    static bool contains(ComponentTypeId id, const Component& instance) {
+        auto& cache = get();
+        if (ComponentMask::covers(id)) {
+            uint64_t bit = uint64_t{1} << (id % 64);
+            if (cache.m_checked[id / 64].load(std::memory_order_acquire) & bit) {
+                return (cache.m_derived[id / 64].load(std::memory_order_relaxed) & bit) != 0;
+            }
+
+            bool derived = dynamic_cast<const T*>(&instance) != nullptr;
+            if (derived) {
+                cache.m_derived[id / 64].fetch_or(bit, std::memory_order_relaxed);
+            }
+            cache.m_checked[id / 64].fetch_or(bit, std::memory_order_release);
+            return derived;
+        }
+
+        {
+            std::shared_lock<std::shared_mutex> lock(cache.m_overflowMutex);
+            auto it = cache.m_overflow.find(id);
+            if (it != cache.m_overflow.end()) {
+                return it->second;
+            }
+        }
+        bool derived = dynamic_cast<const T*>(&instance) != nullptr;
+        std::unique_lock<std::shared_mutex> lock(cache.m_overflowMutex);
+        cache.m_overflow.emplace(id, derived);
+        return derived;
+    }
+
+    /// \brief Gets the masked type IDs already checked against T.
+    static ComponentMask checked() { return load(get().m_checked); }
+
+    /// \brief Gets the masked type IDs known to derive from T.
+    static ComponentMask derived() { return load(get().m_derived); }
+
+private:
+    static DerivedComponentTypes& get() {
+        static DerivedComponentTypes cache;
+        return cache;
+    }
+
+    static ComponentMask load(const std::atomic<uint64_t> (&words)[ComponentMask::WordCount]) {
+        ComponentMask mask;
+        for (size_t i = 0; i < ComponentMask::WordCount; ++i) {
+            mask.words()[i] = words[i].load(std::memory_order_acquire);
+        }
+        return mask;
+    }
+
+    std::atomic<uint64_t> m_checked[ComponentMask::WordCount] = {};
+    std::atomic<uint64_t> m_derived[ComponentMask::WordCount] = {};
+    std::shared_mutex m_overflowMutex;
+    std::unordered_map<ComponentTypeId, bool> m_overflow;
+};
+
+} // namespace vroom
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "vroom/core/JobSystem.hpp"
 #include "vroom/core/SceneManager.hpp"
 #include "vroom/asset/AssetManager.hpp"
 
@@ -16,6 +17,8 @@ struct EngineConfig {
     int windowWidth = 800;
     int windowHeight = 600;
     const char* windowTitle = "VROOM Engine";
+    // Directory for persistent caches (compiled shaders, pipelines). Defaults to "cache" next to the executable.
+    const char* cacheDirectory = nullptr;
 };
 
 class Engine {
@@ -41,11 +44,17 @@ public:
     /// \return Reference to the asset manager.
     AssetManager& getAssetManager() { return *m_assetManager; }
 
+    /// \brief Gets the job system shared by the engine's subsystems.
+    /// \return Reference to the job system.
+    JobSystem& getJobSystem() { return *m_jobSystem; }
+
 private:
     void initWindow();
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
 
     EngineConfig m_config;
+    // Declared first so it outlives every subsystem that queues jobs on it
+    std::unique_ptr<JobSystem> m_jobSystem;
     std::shared_ptr<SceneManager> m_sceneManager;
     std::unique_ptr<AssetManager> m_assetManager;
     bool m_isRunning;
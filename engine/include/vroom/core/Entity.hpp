@@ -1,10 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <type_traits>
 
 #include "vroom/core/Component.hpp"
+#include "vroom/core/ComponentStorage.hpp"
+#include "vroom/core/ComponentType.hpp"
 
 namespace vroom {
 
@@ -13,10 +18,42 @@ class Scene;
 using EntityId = uint64_t;
 constexpr EntityId INVALID_ENTITY_ID = 0;
 
+/// \brief Refers to an entity in a Scene by slot index and generation.
+///
+/// Slots are reused after their entity is destroyed, and each reuse bumps the slot's
+/// generation, so a handle to a destroyed entity never resolves to its successor.
+/// Scene::getEntity() turns a handle back into an Entity, or nullptr if it is stale.
+struct EntityHandle {
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0; // Live slots never have generation 0
+
+    /// \brief Checks whether this handle was ever assigned (it may still be stale).
+    bool isNull() const { return index == InvalidIndex; }
+
+    /// \brief Packs the handle into the EntityId of the entity it refers to.
+    EntityId toId() const { return isNull() ? INVALID_ENTITY_ID : (EntityId{generation} << 32) | index; }
+
+    /// \brief Unpacks an EntityId produced by toId().
+    static EntityHandle fromId(EntityId id) {
+        if (id == INVALID_ENTITY_ID) {
+            return {};
+        }
+        return {static_cast<uint32_t>(id), static_cast<uint32_t>(id >> 32)};
+    }
+
+    bool operator==(const EntityHandle& other) const = default;
+};
+
 /// \brief Represents an entity in the ECS architecture.
 ///
 /// Entities are container objects that hold components. They are identified by a unique ID
-/// and belong to a Scene.
+/// and belong to a Scene. A scene entity's ID is its packed EntityHandle.
+///
+/// Parent and child links are EntityHandles resolved through the scene, so a link to an
+/// entity whose slot was freed no longer resolves. Only entities of the same scene can be
+/// linked; entities outside a scene have no parent or children.
 class Entity {
 public:
     Entity() = default;
@@ -24,7 +61,8 @@ public:
     /// \brief Constructs an entity with a specific ID and scene.
     /// \param id The unique identifier for the entity.
     /// \param scene The scene this entity belongs to.
-    Entity(EntityId id, std::shared_ptr<Scene> scene);
+    /// \param storage Storage that components are allocated from, or nullptr to allocate them individually.
+    Entity(EntityId id, std::shared_ptr<Scene> scene, ComponentStorage* storage = nullptr);
     
     ~Entity();
 
@@ -32,17 +70,37 @@ public:
     /// \return The entity ID.
     EntityId getId() const { return m_id; }
 
-    /// \brief Updates the entity and all its enabled components.
+    /// \brief Gets the handle that refers to this entity in its scene.
+    EntityHandle getHandle() const { return EntityHandle::fromId(m_id); }
+
+    /// \brief Updates the enabled, started components of this entity only.
+    ///
+    /// Components whose type does not override update() are skipped without a call.
+    /// Components are not started here: Scene starts the components queued since its last
+    /// update in one batch before its update loop, which is the only place components are
+    /// started and updated. The caller checks that the entity is active.
     /// \param deltaTime Time elapsed since the last frame.
-    void update(float deltaTime);
+    void updateComponents(float deltaTime);
 
     /// \brief Sets the active state of the entity.
     /// \param active The new active state.
     void setActive(bool active);
 
-    /// \brief Checks if the entity is active.
+    /// \brief Checks if the entity is active, which requires its parent to be active too.
     /// \return True if active, false otherwise.
-    bool isActive() const;
+    bool isActive() const { return m_activeInHierarchy; }
+
+    /// \brief Gets the entity's own active state, as last passed to setActive(), ignoring its parents.
+    bool isActiveSelf() const { return m_active; }
+
+    /// \brief Checks if the entity was destroyed and only awaits removal from its scene.
+    bool isDestroyed() const { return m_destroyed; }
+
+    // Internal use for the scene to flag the entity as destroyed until it is removed
+    void markDestroyed() { m_destroyed = true; }
+
+    // Internal use for components to report that they were started, enabled or disabled
+    void onComponentStateChanged(Component& component);
 
     /// \brief Adds a component to the entity.
     /// \tparam T The type of component to add. Must inherit from Component.
@@ -53,7 +111,10 @@ public:
     T& addComponent(Args&&... args) {
         static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
         
-        auto component = std::make_unique<T>(std::forward<Args>(args)...);
+        // Scene entities keep their components in the scene's per-type pools
+        std::unique_ptr<T, ComponentDeleter> component = m_storage
+            ? m_storage->create<T>(std::forward<Args>(args)...)
+            : std::unique_ptr<T, ComponentDeleter>(new T(std::forward<Args>(args)...));
         component->setEntity(this);
         
         component->awake();
@@ -63,19 +124,42 @@ public:
         }
         
         T* componentPtr = component.get();
-        m_components.push_back(std::move(component));
+        registerComponent(componentTypeId<T>(), std::move(component), overridesUpdate<T>());
         return *componentPtr;
     }
 
+    /// \brief Removes the first component of exactly type T, if the entity has one.
+    ///
+    /// The component gets onDisable() if it was enabled on an active entity, then onDestroy().
+    /// Must not be called from an update of this entity; record it in an EntityCommandBuffer instead.
+    /// \tparam T The concrete type of component to remove.
+    /// \return True if a component was removed.
+    template <typename T>
+    bool removeComponent() {
+        static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+        return removeComponent(componentTypeId<T>());
+    }
+
+    /// \brief Removes the first component of exactly the given type, if the entity has one.
+    /// \param type The component type ID, see componentTypeId().
+    /// \return True if a component was removed.
+    bool removeComponent(ComponentTypeId type);
+
     /// \brief Retrieves a component of a specific type.
+    ///
+    /// A component of exactly type T is found with a bit test. Otherwise a component whose
+    /// type derives from T is returned; if there are several, which one is unspecified.
     /// \tparam T The type of component to retrieve.
     /// \return Pointer to the component if found, nullptr otherwise.
     template <typename T>
     T* getComponent() {
-        for (auto& component : m_components) {
-            if (T* casted = dynamic_cast<T*>(component.get())) {
-                return casted;
-            }
+        static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+
+        if (Component* component = findComponent(componentTypeId<T>())) {
+            return static_cast<T*>(component);
+        }
+        if constexpr (!std::is_final_v<T>) {
+            return static_cast<T*>(findDerivedComponent<T>());
         }
         return nullptr;
     }
@@ -85,21 +169,38 @@ public:
     /// \return Const pointer to the component if found, nullptr otherwise.
     template <typename T>
     const T* getComponent() const {
-        for (const auto& component : m_components) {
-            if (const T* casted = dynamic_cast<const T*>(component.get())) {
-                return casted;
+        return const_cast<Entity*>(this)->getComponent<T>();
+    }
+
+    /// \brief Gets the set of component types (with IDs below MaxMaskedComponentTypes) on this entity.
+    const ComponentMask& getComponentMask() const { return m_componentMask; }
+
+    /// \brief Finds the first component of exactly the given type.
+    /// \param type The component type ID, see componentTypeId().
+    /// \return Pointer to the component if found, nullptr otherwise.
+    Component* findComponent(ComponentTypeId type) const {
+        if (ComponentMask::covers(type)) {
+            if (!m_componentMask.test(type)) {
+                return nullptr;
             }
+            return m_components[m_maskedIndex[m_componentMask.countBelow(type)]].get();
         }
-        return nullptr;
+
+        auto it = std::lower_bound(m_overflowIndex.begin(), m_overflowIndex.end(), type,
+            [](const auto& entry, ComponentTypeId id) { return entry.first < id; });
+        return it != m_overflowIndex.end() && it->first == type ? m_components[it->second].get() : nullptr;
     }
 
     /// \brief Sets the parent of this entity.
-    /// \param parent The new parent entity.
+    /// \param parent The new parent entity, which must be in the same scene, or nullptr.
     void setParent(Entity* parent);
 
     /// \brief Gets the parent of this entity.
-    /// \return Pointer to the parent entity.
-    Entity* getParent() const { return m_parent; }
+    /// \return Pointer to the parent entity, or nullptr if there is none or its slot was freed.
+    Entity* getParent() const;
+
+    /// \brief Gets the handle of the parent of this entity, which is null for roots.
+    EntityHandle getParentHandle() const { return m_parent; }
 
     /// \brief Adds a child entity.
     /// \param child The child entity to add.
@@ -109,24 +210,86 @@ public:
     /// \param child The child entity to remove.
     void removeChild(Entity* child);
 
-    /// \brief Gets the children of this entity.
-    /// \return Reference to the vector of children.
-    const std::vector<Entity*>& getChildren() const { return m_children; }
+    /// \brief Gets the handles of the children of this entity, in the order they were added.
+    const std::vector<EntityHandle>& getChildren() const { return m_children; }
+
+    /// \brief Resolves the child at index in getChildren().
+    /// \return Pointer to the child, or nullptr if its slot was freed.
+    Entity* getChild(size_t index) const;
+
+    /// \brief Gets the scene this entity is in, or nullptr if it is not part of one.
+    std::shared_ptr<Scene> getScene() const { return m_scene.lock(); }
 
     /// \brief Gets the SceneManager that owns the scene this entity is in.
     /// \return Pointer to the SceneManager, or nullptr if not attached.
     class SceneManager* getSceneManager() const;
 
 private:
+    /// \brief Resolves a parent or child link through the scene, including entities destroyed but not flushed yet.
+    Entity* resolveLink(EntityHandle handle) const;
+
     /// \brief Helper to handle active state changes recursively.
     void handleActiveStateChange(bool wasActive, bool isNowActive);
 
+    /// \brief Stores the effective active state of this entity and its subtree.
+    void propagateActiveInHierarchy(bool active);
+
+    /// \brief Takes ownership of a new component and indexes it by type.
+    /// \param updatable Whether the component's type overrides update().
+    void registerComponent(ComponentTypeId type, ComponentPtr component, bool updatable);
+
+    /// \brief Takes a component off m_updatableComponents, or nulls its entry while they update.
+    void removeUpdatable(Component* component);
+
+    /// \brief Points the type index of type at its first component, or drops it if there is none.
+    void reindexComponentType(ComponentTypeId type);
+
+    /// \brief Finds a component whose type derives from T.
+    template <typename T>
+    Component* findDerivedComponent() const {
+        // Classify component types this entity has that were never checked against T
+        ComponentMask unchecked = m_componentMask & ~DerivedComponentTypes<T>::checked();
+        unchecked.forEach([this](ComponentTypeId type) {
+            DerivedComponentTypes<T>::contains(type, *findComponent(type));
+        });
+
+        ComponentMask matches = m_componentMask & DerivedComponentTypes<T>::derived();
+        if (matches.any()) {
+            return findComponent(matches.lowest());
+        }
+
+        for (const auto& [type, index] : m_overflowIndex) {
+            if (DerivedComponentTypes<T>::contains(type, *m_components[index])) {
+                return m_components[index].get();
+            }
+        }
+        return nullptr;
+    }
+
     EntityId m_id = INVALID_ENTITY_ID;
     std::weak_ptr<Scene> m_scene;
-    std::vector<std::unique_ptr<Component>> m_components;
+    // Resolves parent and child links. The scene owns the entity, so it outlives it; unlike
+    // m_scene, it still resolves while the scene destroys its entities.
+    Scene* m_linkScene = nullptr;
+    ComponentStorage* m_storage = nullptr;
+    std::vector<ComponentPtr> m_components; // In the order they were added
+    std::vector<ComponentTypeId> m_componentTypes; // Type of each entry of m_components
+    // Started, enabled components overriding update(). Entries dropped while they update are
+    // nulled, and erased once the loop is done
+    std::vector<Component*> m_updatableComponents;
+    bool m_updatingComponents = false;
+    bool m_hasDroppedUpdatables = false;
+    // Type lookup: for each type set in m_componentMask, in ascending ID order, the index of
+    // its first component, so a type's slot is the number of lower bits set in the mask
+    ComponentMask m_componentMask;
+    std::vector<uint32_t> m_maskedIndex;
+    std::vector<std::pair<ComponentTypeId, uint32_t>> m_overflowIndex; // Sorted by type
     bool m_active = true;
-    Entity* m_parent = nullptr;
-    std::vector<Entity*> m_children;
+    // m_active of this entity and all its ancestors, kept up to date by setActive() and setParent()
+    bool m_activeInHierarchy = true;
+    bool m_destroyed = false;
+    EntityHandle m_parent;
+    std::vector<EntityHandle> m_children;
 };
 
 } // namespace vroom
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/ComponentType.hpp"
+#include "vroom/core/Entity.hpp"
+
+namespace vroom {
+
+class Scene;
+
+/// \brief Records structural changes to a Scene so they can be applied later on the main thread.
+///
+/// Jobs and systems cannot create or destroy entities, or add and remove components, while
+/// other threads iterate the scene. Instead each job records into a buffer of its own, which
+/// needs no locking, and hands it to Scene::submitCommands(). The scene plays the submitted
+/// buffers back after its systems have run, in order of their sort keys, so the result does
+/// not depend on which worker finished first.
+///
+/// createEntity() returns a placeholder handle that later commands of the same buffer may
+/// use wherever they take an entity. It never resolves in the scene itself.
+class EntityCommandBuffer {
+public:
+    /// \param sortKey Orders this buffer against others at playback, lowest first. Buffers
+    /// with equal keys play back in submission order, so give every job its own key (such
+    /// as its parallelFor index) for deterministic results.
+    explicit EntityCommandBuffer(uint64_t sortKey = 0) : m_sortKey(sortKey) {}
+
+    /// \brief Gets the key that orders this buffer at playback.
+    uint64_t getSortKey() const { return m_sortKey; }
+
+    /// \brief Gets the number of recorded commands.
+    size_t size() const { return m_commands.size(); }
+
+    bool empty() const { return m_commands.empty(); }
+
+    /// \brief Records the creation of an entity.
+    /// \return Placeholder for the new entity, valid only in commands of this buffer.
+    EntityHandle createEntity();
+
+    /// \brief Records the destruction of an entity and all its children.
+    void destroyEntity(EntityHandle entity);
+
+    /// \brief Records adding a component of type T to an entity.
+    /// \tparam T The type of component to add. Must inherit from Component.
+    /// \param entity The entity, or a placeholder from createEntity().
+    /// \param args Arguments for the component's constructor. They are copied into the
+    /// buffer; wrap them in std::ref to pass references.
+    template <typename T, typename... Args>
+    void addComponent(EntityHandle entity, Args&&... args) {
+        static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+        Command& command = record(CommandType::AddComponent, entity);
+        // Each command runs once, so the stored arguments are moved into the constructor
+        command.addComponent = [arguments = std::make_tuple(std::forward<Args>(args)...)](Entity& target) mutable {
+            std::apply([&target](auto&&... unpacked) {
+                target.addComponent<T>(std::forward<decltype(unpacked)>(unpacked)...);
+            }, std::move(arguments));
+        };
+    }
+
+    /// \brief Records removing the first component of exactly type T from an entity.
+    template <typename T>
+    void removeComponent(EntityHandle entity) {
+        static_assert(std::is_base_of_v<Component, T>, "T must inherit from Component");
+        record(CommandType::RemoveComponent, entity).componentType = componentTypeId<T>();
+    }
+
+    /// \brief Records reparenting an entity.
+    /// \param entity The entity to move.
+    /// \param parent The new parent, or a null handle to make entity a root.
+    void setParent(EntityHandle entity, EntityHandle parent);
+
+    /// \brief Applies every recorded command to scene, in recording order, and empties the buffer.
+    ///
+    /// Commands whose entity was destroyed (or whose handle is stale) are skipped.
+    /// Must be called on the thread that owns the scene.
+    void playback(Scene& scene);
+
+    /// \brief Discards every recorded command.
+    void clear();
+
+private:
+    enum class CommandType : uint8_t {
+        CreateEntity,
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent,
+        SetParent,
+    };
+
+    struct Command {
+        CommandType type;
+        EntityHandle entity;
+        EntityHandle parent; // SetParent
+        ComponentTypeId componentType = 0; // RemoveComponent
+        std::function<void(Entity&)> addComponent; // AddComponent
+    };
+
+    Command& record(CommandType type, EntityHandle entity);
+
+    /// \brief Turns a handle or placeholder into the scene entity it stands for.
+    Entity* resolve(Scene& scene, EntityHandle handle, const std::vector<EntityHandle>& created) const;
+
+    uint64_t m_sortKey;
+    std::vector<Command> m_commands;
+    uint32_t m_createdCount = 0;
+};
+
+} // namespace vroom
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vroom {
+
+/// \brief 64-bit FNV-1a hash of a byte range.
+///
+/// Fast and stable across runs and platforms, so it can key and checksum files on disk.
+/// Not suitable where collisions could be crafted on purpose.
+constexpr uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace vroom
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vroom {
+
+/// \brief Tracks a group of jobs so a caller can wait for all of them.
+///
+/// Pass the same counter to several JobSystem::run() calls, then JobSystem::wait() on it.
+/// The counter must outlive the jobs it tracks.
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /// \brief Checks whether every job tracked by this counter has finished.
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_mutex;
+    std::condition_variable m_finished;
+    std::exception_ptr m_error; // First exception thrown by a tracked job
+};
+
+/// \brief Engine-wide pool of worker threads that balance load by stealing jobs.
+///
+/// Every worker owns a deque. Jobs queued from a worker go to the back of its own deque
+/// and it takes them back newest first, which keeps related work on one core; idle
+/// workers steal the oldest jobs from the front of other deques. Jobs queued from other
+/// threads go through a shared queue.
+///
+/// Waiting on a JobCounter runs queued jobs instead of blocking, so jobs may queue
+/// sub-jobs and wait for them without tying up a worker. Jobs still queued when the
+/// system is destroyed are run before the workers exit.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /// \brief Starts the worker threads.
+    /// \param threadCount Number of workers. 0 picks one per hardware thread.
+    explicit JobSystem(size_t threadCount = 0);
+
+    /// \brief Runs every queued job and joins the workers.
+    ~JobSystem();
+
+    // Prevent copying
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// \brief Queues a job.
+    /// \param job The callable to run.
+    /// \param counter Counter tracking the job, or nullptr. If the job throws, wait() on the
+    /// counter rethrows the first exception; without a counter the exception is logged.
+    void run(Job job, JobCounter* counter = nullptr);
+
+    /// \brief Queues a callable and returns a future for its result.
+    /// \param function The callable to run.
+    /// \return A future holding the callable's result (or the exception it threw).
+    template <typename F>
+    auto submit(F&& function) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        // packaged_task is move-only, std::function needs copyable targets
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+        auto future = task->get_future();
+        run([task]() { (*task)(); });
+        return future;
+    }
+
+    /// \brief Waits until every job tracked by counter has finished, running queued jobs meanwhile.
+    ///
+    /// Rethrows the first exception thrown by one of those jobs. Once this returns the counter
+    /// may be destroyed; isDone() alone does not guarantee that.
+    void wait(JobCounter& counter);
+
+    /// \brief Calls fn(i) for every i in [0, count), spread across the workers, and waits.
+    /// \param count Number of iterations.
+    /// \param fn Callable taking a size_t index. Called concurrently.
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        // A few batches per worker leaves room for stealing to even out uneven iterations
+        size_t batchSize = std::max<size_t>(1, count / (getThreadCount() * 4));
+        JobCounter counter;
+        for (size_t begin = 0; begin < count; begin += batchSize) {
+            size_t end = std::min(count, begin + batchSize);
+            run([&fn, begin, end]() {
+                for (size_t i = begin; i < end; ++i) {
+                    fn(i);
+                }
+            }, &counter);
+        }
+        wait(counter);
+    }
+
+    /// \brief Gets the number of worker threads.
+    size_t getThreadCount() const { return m_workers.size(); }
+
+    /// \brief Checks whether the calling thread is one of this system's workers.
+    bool isWorkerThread() const;
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    void workerLoop(size_t index);
+
+    /// \brief Takes the next job for the worker at index (or a non-worker thread if index is npos).
+    bool takeJob(size_t index, QueuedJob& out);
+
+    void execute(QueuedJob& job);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::deque<QueuedJob> m_sharedJobs; // Queued from threads that are not workers
+    std::mutex m_sharedMutex;
+
+    std::atomic<size_t> m_queuedJobs{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    bool m_stopping = false;
+};
+
+} // namespace vroom
@@ -3,7 +3,15 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include "vroom/core/Entity.hpp"
+#include "vroom/core/EntityCommandBuffer.hpp"
+#include "vroom/core/SceneHierarchy.hpp"
+#include "vroom/core/TransformStorage.hpp"
+#include "vroom/core/SceneQuery.hpp"
+#include "vroom/core/System.hpp"
 
 namespace vroom {
 
@@ -13,6 +21,8 @@ public:
     ~Scene();
 
     /// \brief Creates a new entity in the scene.
+    ///
+    /// Entities created while the scene is updating are first updated on the next frame.
     /// \return Reference to the newly created entity.
     Entity& createEntity();
 
@@ -25,27 +35,209 @@ public:
     SceneManager* getSceneManager() const { return m_sceneManager; }
 
     /// \brief Destroys an entity and all its children.
+    ///
+    /// The entities are marked destroyed right away: handles to them stop resolving and
+    /// they are skipped by updates and queries. Their components are destroyed and their
+    /// slots freed in one batch at the end of the next update, or by flushDestroyedEntities().
     /// \param entity The entity to destroy.
     void destroyEntity(Entity& entity);
 
+    /// \brief Destroys the entity a handle refers to, and all its children. Stale handles are ignored.
+    /// \param handle Handle to the entity to destroy.
+    void destroyEntity(EntityHandle handle);
+
+    /// \brief Resolves a handle to its entity.
+    /// \param handle The handle to resolve.
+    /// \return Pointer to the entity, or nullptr if the handle is null or its entity was destroyed.
+    ///         Destroyed entities no longer resolve even before they are flushed.
+    Entity* getEntity(EntityHandle handle) {
+        if (handle.index >= m_slots.size()) {
+            return nullptr;
+        }
+        EntitySlot& slot = m_slots[handle.index];
+        if (slot.generation != handle.generation || !slot.entity || slot.entity->isDestroyed()) {
+            return nullptr;
+        }
+        return &*slot.entity;
+    }
+
+    // Internal use for entities to resolve their parent and child links. Unlike getEntity(),
+    // destroyed entities still resolve until they are flushed.
+    Entity* getLinkedEntity(EntityHandle handle) {
+        if (handle.index >= m_slots.size()) {
+            return nullptr;
+        }
+        EntitySlot& slot = m_slots[handle.index];
+        return slot.generation == handle.generation && slot.entity ? &*slot.entity : nullptr;
+    }
+
+    /// \brief Checks whether a handle refers to a live entity of this scene.
+    bool isValid(EntityHandle handle) { return getEntity(handle) != nullptr; }
+
+    /// \brief Gets the number of live entities in the scene.
+    size_t getEntityCount() const { return m_entityCount; }
+
+    /// \brief Removes every entity destroyed since the last flush.
+    void flushDestroyedEntities();
+
+    /// \brief Hands over recorded structural changes, to be applied by the next playbackCommands().
+    ///
+    /// Thread-safe, so jobs and systems may submit their buffers while the scene is updating.
+    /// \param commands The recorded buffer.
+    void submitCommands(EntityCommandBuffer&& commands);
+
+    /// \brief Plays back every submitted command buffer, ordered by sort key.
+    ///
+    /// Called by update() after the systems have run, before destroyed entities are flushed.
+    void playbackCommands();
+
     /// \brief Updates all entities in the scene.
     /// \param deltaTime Time elapsed since the last frame.
     void update(float deltaTime);
 
+    /// \brief Brings the world matrices of transforms changed since the last call up to date.
+    /// Called at the end of update().
+    void updateTransforms() { m_transforms.propagate(*this); }
+
+    /// \brief Gets the storage holding the data of this scene's Transform components.
+    TransformStorage& getTransforms() { return m_transforms; }
+
     /// \brief Removes all entities from the scene.
     void clear();
 
     /// \brief Gets all root entities in the scene.
-    /// \return Vector of pointers to root entities.
+    /// \return Vector of pointers to root entities, in hierarchy order.
     std::vector<Entity*> getRootEntities() const;
 
+    /// \brief Gets the scene's entities flattened in parent-before-child order.
+    ///
+    /// Reparenting while the scene updates its entities is applied to the hierarchy once
+    /// that loop is done, so it is up to date for systems and between frames.
+    const SceneHierarchy& getHierarchy() const { return m_hierarchy; }
+
+    /// \brief Visits every component of exactly type T in the scene.
+    ///
+    /// Components are visited in storage order, which is a linear walk over the type's pool.
+    /// Components of types derived from T are not included, and inactive entities and disabled
+    /// components are visited too.
+    /// \tparam T The concrete component type.
+    /// \param fn Callable invoked with a T& for each component.
+    template <typename T, typename Fn>
+    void forEachComponent(Fn&& fn) {
+        if (auto* pool = m_componentStorage.findPool<T>()) {
+            pool->forEach(std::forward<Fn>(fn));
+        }
+    }
+
+    /// \brief Gets the entities that have a component of each of the types Ts.
+    ///
+    /// The matching set is built on the first query for Ts and then kept up to date as
+    /// components are added and removed and entities destroyed, so iterating it costs O(matches).
+    /// \tparam Ts The concrete component types.
+    /// \return View over the matching entities, valid as long as the scene.
+    template <typename... Ts>
+    SceneQuery<Ts...> query() {
+        size_t id = queryId<Ts...>();
+        if (id >= m_queries.size()) {
+            m_queries.resize(id + 1);
+        }
+        auto& cache = m_queries[id];
+        if (!cache) {
+            cache = buildQuery({componentTypeId<Ts>()...});
+        }
+        return SceneQuery<Ts...>(*cache);
+    }
+
+    /// \brief Visits every entity that has a component of each of the types Ts.
+    /// \param fn Callable invoked with (Entity&, Ts&...) or (Ts&...) for each match.
+    template <typename... Ts, typename Fn>
+    void each(Fn&& fn) {
+        query<Ts...>().each(std::forward<Fn>(fn));
+    }
+
+    /// \brief Registers a system that runs every frame after the entities are updated.
+    ///
+    /// Systems that do not conflict run in parallel on the SceneManager's job system.
+    /// \tparam T The system type. Must inherit from System.
+    /// \param args Arguments forwarded to the system's constructor.
+    /// \return Reference to the new system.
+    template <typename T, typename... Args>
+    T& addSystem(Args&&... args) {
+        return m_systems.addSystem<T>(std::forward<Args>(args)...);
+    }
+
+    /// \brief Gets the scheduler running this scene's systems.
+    SystemScheduler& getSystems() { return m_systems; }
+
+    /// \brief Updates cached queries after entity gained its first component of type.
+    void onComponentAdded(Entity& entity, ComponentTypeId type);
+
+    /// \brief Updates cached queries and the start queue after entity lost component, of type.
+    void onComponentRemoved(Entity& entity, ComponentTypeId type, Component& component);
+
+    /// \brief Queues a component of entity to be started before its first update.
+    /// Entities queue components as they are added, enabled or activated, if they can start.
+    void queueStart(Entity& entity, Component& component);
+
+    /// \brief Calls start() on the queued components whose entity is active and that are enabled.
+    ///
+    /// The queue is emptied: components that cannot start anymore are queued again by their
+    /// entity when they can, so none are polled frame after frame. Called by update() before
+    /// the entities update, so the update loop itself never has to start components.
+    void startComponents();
+
+    /// \brief Moves entity within the hierarchy after its parent changed.
+    void onParentChanged(Entity& entity, Entity* oldParent);
+
+    /// \brief Gets the storage that this scene's components are allocated from.
+    ComponentStorage& getComponentStorage() { return m_componentStorage; }
+
 private:
-    EntityId m_nextEntityId = 1;
-    std::vector<std::shared_ptr<Entity>> m_entities;
+    struct PendingStart {
+        EntityHandle entity;
+        Component* component; // nullptr once removed from its entity
+    };
+
+    struct EntitySlot {
+        std::optional<Entity> entity;
+        uint32_t generation = 1; // Bumped each time the slot's entity is destroyed
+    };
+
+    // Declared before the entities so they outlive the components the entities own
+    ComponentStorage m_componentStorage;
+    TransformStorage m_transforms;
+    // Indexed by EntityHandle::index. A deque never moves its elements as it grows,
+    // so entities keep their address for as long as they live.
+    std::deque<EntitySlot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    size_t m_entityCount = 0;
+    SceneHierarchy m_hierarchy;
+    bool m_updating = false; // Walking the hierarchy in update()
+    bool m_hierarchyDirty = false; // Reparented during the walk
+    // Slots of destroyed entities awaiting removal, each parent before its descendants
+    std::vector<uint32_t> m_destroyedSlots;
     SceneManager* m_sceneManager = nullptr;
-    
-    // Helper to generate unique IDs
-    EntityId generateEntityId();
+    std::vector<std::unique_ptr<QueryCache>> m_queries; // Indexed by queryId()
+    SystemScheduler m_systems;
+    std::vector<PendingStart> m_pendingStarts;
+    std::mutex m_commandMutex;
+    std::vector<EntityCommandBuffer> m_submittedCommands; // Guarded by m_commandMutex
+
+    std::unique_ptr<QueryCache> buildQuery(std::vector<ComponentTypeId> types);
+
+    /// \brief Destroys the entity in a slot right away and frees the slot.
+    void destroySlot(uint32_t index);
+
+    /// \brief Calls fn with every entity that is not destroyed, in slot order.
+    /// Entities are passed mutable even from const members.
+    template <typename Fn>
+    void forEachEntity(Fn&& fn) const {
+        for (const EntitySlot& slot : m_slots) {
+            if (slot.entity && !slot.entity->isDestroyed()) {
+                fn(const_cast<Entity&>(*slot.entity));
+            }
+        }
+    }
 };
 
 } // namespace vroom
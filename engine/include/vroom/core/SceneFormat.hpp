@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vroom {
+
+constexpr uint32_t SCENE_VERSION_1 = 1;
+
+// Chunks start on this boundary, and so do the arrays inside them
+constexpr uint32_t SCENE_CHUNK_ALIGNMENT = 8;
+
+/// \brief Header of a binary scene file.
+///
+/// Layout: header, then chunkCount chunks back to back. The first chunk is always the
+/// entity chunk; each component type saved follows in a chunk of its own. Readers skip
+/// chunks whose tag they do not know, so chunks can be added without a version bump.
+struct SceneFileHeader {
+    char magic[4] = {'V', 'R', 'S', 'N'}; // VRoom SceNe, distinct from the shader cache's VRSC
+    uint32_t version = SCENE_VERSION_1;
+    uint32_t chunkCount = 0;
+    uint32_t reserved = 0;
+};
+
+/// \brief Header in front of every chunk. The payload is size bytes, padding included.
+///
+/// Entity chunk ("ENTS"): elementCount SceneEntityRecord.
+/// Component chunk ("COMP"): the type name (nameLength bytes), then elementCount entity
+/// indices (uint32_t), then elementCount values of elementSize bytes each, every array
+/// starting on SCENE_CHUNK_ALIGNMENT.
+struct SceneChunkHeader {
+    char tag[4];
+    uint32_t elementCount = 0;
+    uint32_t elementSize = 0;
+    uint32_t nameLength = 0;
+    uint64_t size = 0;
+};
+
+/// \brief Entity in the entity chunk, which lists entities with every parent before its children.
+struct SceneEntityRecord {
+    uint32_t parent; // Index in the entity chunk, or SCENE_NO_PARENT
+    uint32_t flags;
+};
+
+constexpr uint32_t SCENE_NO_PARENT = UINT32_MAX;
+constexpr uint32_t SCENE_ENTITY_INACTIVE = 1 << 0; // setActive(false) was called on it
+
+constexpr char SCENE_ENTITY_CHUNK[4] = {'E', 'N', 'T', 'S'};
+constexpr char SCENE_COMPONENT_CHUNK[4] = {'C', 'O', 'M', 'P'};
+
+static_assert(sizeof(SceneFileHeader) == 16, "SceneFileHeader layout is part of the file format");
+static_assert(sizeof(SceneChunkHeader) == 24, "SceneChunkHeader layout is part of the file format");
+static_assert(sizeof(SceneEntityRecord) == 8, "SceneEntityRecord layout is part of the file format");
+
+/// \brief Rounds offset up to the next SCENE_CHUNK_ALIGNMENT boundary.
+constexpr uint64_t alignSceneOffset(uint64_t offset) {
+    return (offset + SCENE_CHUNK_ALIGNMENT - 1) & ~static_cast<uint64_t>(SCENE_CHUNK_ALIGNMENT - 1);
+}
+
+} // namespace vroom
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vroom {
+
+class Entity;
+
+/// \brief Flattened entity hierarchy of a Scene, with every parent stored before its children.
+///
+/// Entities are kept in depth-first pre-order, so each subtree occupies a contiguous range
+/// starting at its root. Hierarchical passes can therefore run as a single linear loop
+/// that reads results of parents already processed, and root subtrees (found by stepping
+/// from one root to the next with getSubtreeSize()) can be handed to different threads.
+///
+/// The Scene moves subtrees within the arrays as entities are reparented instead of
+/// rebuilding them. Positions shift when the hierarchy changes, so they must not be kept
+/// across structural changes.
+class SceneHierarchy {
+public:
+    /// \brief Position of no entity: the parent of roots, or what find() returns for entities it does not hold.
+    static constexpr uint32_t NoPosition = UINT32_MAX;
+
+    /// \brief Gets the number of entities, including destroyed ones not yet flushed.
+    size_t size() const { return m_entities.size(); }
+
+    /// \brief Gets the entity at a position.
+    Entity& getEntity(size_t position) const { return *m_entities[position]; }
+
+    /// \brief Gets the slot (EntityHandle::index) of the entity at a position, without reading the entity.
+    uint32_t getSlot(size_t position) const { return m_slots[position]; }
+
+    /// \brief Gets the position of the entity's parent, which is always lower, or NoPosition for roots.
+    uint32_t getParent(size_t position) const { return m_parents[position]; }
+
+    /// \brief Gets the number of entities in the subtree rooted at a position, itself included.
+    uint32_t getSubtreeSize(size_t position) const { return m_subtreeSizes[position]; }
+
+    /// \brief Finds the position of an entity, or NoPosition if it is not part of this hierarchy.
+    uint32_t find(const Entity& entity) const;
+
+    /// \brief Appends a new entity without parent or children as a root.
+    void add(Entity& entity);
+
+    /// \brief Moves the subtree of entity under its new parent (or to the roots, at the end).
+    /// \param entity The entity, whose parent link has already been changed.
+    /// \param oldParent The parent entity had before.
+    void reparent(Entity& entity, Entity* oldParent);
+
+    /// \brief Drops every destroyed entity in one pass, keeping the order of the others.
+    /// \param removedSlots Receives the slot index of each dropped entity, in pre-order.
+    void removeDestroyed(std::vector<uint32_t>& removedSlots);
+
+    /// \brief Rebuilds the arrays from the entities' parent links, keeping the order of the roots.
+    void rebuild();
+
+    /// \brief Removes every entity.
+    void clear();
+
+private:
+    /// \brief Appends entity and its descendants for which contains() holds, in pre-order.
+    template <typename Contains>
+    void appendSubtree(Entity& entity, const Contains& contains);
+
+    /// \brief Recomputes the parent positions and subtree sizes from the entity order.
+    void recomputeLinks();
+
+    std::vector<Entity*> m_entities;
+    std::vector<uint32_t> m_slots;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_subtreeSizes;
+    std::vector<uint32_t> m_positions; // Indexed by EntityHandle::index
+};
+
+} // namespace vroom
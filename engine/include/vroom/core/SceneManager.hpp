@@ -5,10 +5,14 @@
 #include <vector>
 #include <future>
 #include <mutex>
+#include <functional>
 #include "vroom/core/Scene.hpp"
+#include "vroom/core/JobSystem.hpp"
 
 namespace vroom {
 
+class ComponentRegistry;
+
 class SceneManager : public std::enable_shared_from_this<SceneManager> {
 public:
     SceneManager();
@@ -37,6 +41,16 @@ public:
     /// \return A future that completes when the scene is loaded.
     std::future<void> loadSceneAdditiveAsync(const std::string& path);
 
+    /// \brief Saves a scene to a file that loadScene() can load.
+    /// \param scene The scene to save.
+    /// \param path Path of the file, which holds JSON if it ends in .json and the binary form otherwise.
+    /// \return False if the file could not be written.
+    bool saveScene(Scene& scene, const std::string& path) const;
+
+    /// \brief Gets the component types scenes are saved and loaded with.
+    /// Register game component types here before loading scenes that hold them.
+    ComponentRegistry& getComponentRegistry() { return *m_componentRegistry; }
+
     /// \brief Unloads a specific scene.
     /// \param scene The scene to unload.
     void unloadScene(std::shared_ptr<Scene> scene);
@@ -49,10 +63,25 @@ public:
     /// \return Shared pointer to the active scene.
     std::shared_ptr<Scene> getActiveScene() const;
 
+    /// \brief Sets the job system that async loads and scene systems run on.
+    /// \param jobs The job system, which must outlive this manager. nullptr reverts to a private one.
+    void setJobSystem(JobSystem* jobs);
+
+    /// \brief Gets the job system, starting a private one on first use if none was set.
+    JobSystem& getJobSystem();
+
 private:
     std::vector<std::shared_ptr<Scene>> m_scenes;
     std::shared_ptr<Scene> m_activeScene;
     mutable std::mutex m_mutex;
+    std::mutex m_jobMutex;
+    JobSystem* m_jobSystem = nullptr;
+    std::unique_ptr<JobSystem> m_ownedJobSystem;
+    JobCounter m_pendingLoads;
+    std::unique_ptr<ComponentRegistry> m_componentRegistry;
+
+    /// \brief Runs load on the job system, tracked so the destructor can wait for it.
+    std::future<void> runLoadJob(std::function<void()> load);
 
 protected:
     // Internal helper for loading logic, protected for testing
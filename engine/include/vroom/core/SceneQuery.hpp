@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/ComponentType.hpp"
+#include "vroom/core/Entity.hpp"
+
+namespace vroom {
+
+/// \brief Cached set of the entities in a Scene that have every component type in a query.
+///
+/// The scene keeps the cache up to date as components are added and removed and entities destroyed,
+/// so iterating a query only touches matching entities. Each match stores its components
+/// next to the entity, in the order the query lists the types.
+class QueryCache {
+public:
+    /// \param types Component types an entity needs to match, in query order.
+    explicit QueryCache(std::vector<ComponentTypeId> types);
+
+    /// \brief Gets the component types of the query, in query order.
+    const std::vector<ComponentTypeId>& getTypes() const { return m_types; }
+
+    /// \brief Checks whether type is one of the query's component types.
+    bool involves(ComponentTypeId type) const {
+        return std::find(m_types.begin(), m_types.end(), type) != m_types.end();
+    }
+
+    /// \brief Adds entity to the matches if it has every component type of the query.
+    /// The entity must not already be a match.
+    void tryAdd(Entity& entity);
+
+    /// \brief Removes entity from the matches, if it is one. The last match takes its place,
+    /// unless the matches are being iterated: then the entry is nulled until the iteration ends.
+    void remove(Entity& entity);
+
+    /// \brief Removes every match whose entity is marked destroyed, in one pass.
+    void removeDestroyed();
+
+    /// \brief Removes all matches.
+    void clear();
+
+    /// \brief Gets the number of matching entities, including destroyed ones not yet removed
+    /// and, while iterating, the nulled entries of removed ones.
+    size_t size() const { return m_entities.size(); }
+
+    /// \brief Gets the entity of a match, or nullptr if it was removed while iterating.
+    Entity* getEntity(size_t match) const { return m_entities[match]; }
+
+    // Internal use for SceneQuery::each() to keep match positions stable while it runs
+    void beginIteration() { ++m_iterations; }
+    void endIteration();
+
+    /// \brief Gets the match's component of the type at position slot in the query.
+    Component* getComponent(size_t match, size_t slot) const { return m_components[match * m_types.size() + slot]; }
+
+private:
+    std::vector<ComponentTypeId> m_types;
+    std::vector<Entity*> m_entities;
+    std::vector<Component*> m_components; // m_types.size() per match
+    uint32_t m_iterations = 0; // Nested SceneQuery::each() calls running
+    bool m_hasRemovedWhileIterating = false;
+};
+
+namespace detail {
+/// \brief Hands out the next unused query ID. Thread-safe.
+size_t nextQueryId();
+} // namespace detail
+
+/// \brief Gets the ID of the query over component types Ts, used to find its cache in a Scene.
+template <typename... Ts>
+size_t queryId() {
+    static const size_t id = detail::nextQueryId();
+    return id;
+}
+
+/// \brief View over the entities of a Scene that have a component of each type Ts.
+///
+/// Types are matched exactly, like Scene::forEachComponent: a component of a type derived
+/// from one of Ts does not count. Inactive entities and disabled components are included.
+/// \tparam Ts The concrete component types.
+template <typename... Ts>
+class SceneQuery {
+public:
+    static_assert(sizeof...(Ts) > 0, "A query needs at least one component type");
+    static_assert((std::is_base_of_v<Component, Ts> && ...), "Ts must inherit from Component");
+
+    explicit SceneQuery(QueryCache& cache) : m_cache(&cache) {}
+
+    /// \brief Gets the number of matching entities.
+    /// Entities destroyed since the scene last removed destroyed entities are still counted.
+    size_t size() const { return m_cache->size(); }
+
+    bool empty() const { return m_cache->size() == 0; }
+
+    /// \brief Visits every matching entity that is not destroyed, in unspecified order.
+    ///
+    /// Entities that start matching while iterating are not visited, and ones that stop
+    /// matching (a queried component removed, or the entity destroyed) are not visited after.
+    /// Removed matches only leave the cache once the outermost iteration is done, so the
+    /// others keep their place and are each visited once.
+    /// \param fn Callable invoked with (Entity&, Ts&...) or (Ts&...) for each match.
+    template <typename Fn>
+    void each(Fn&& fn) const {
+        each(fn, std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    template <typename Fn, size_t... Slots>
+    void each(Fn& fn, std::index_sequence<Slots...>) const {
+        struct IterationScope {
+            QueryCache& cache;
+            explicit IterationScope(QueryCache& cache) : cache(cache) { cache.beginIteration(); }
+            ~IterationScope() { cache.endIteration(); }
+        } scope(*m_cache);
+
+        size_t count = m_cache->size();
+        for (size_t match = 0; match < count; ++match) {
+            Entity* entity = m_cache->getEntity(match);
+            if (!entity || entity->isDestroyed()) {
+                continue;
+            }
+            if constexpr (std::is_invocable_v<Fn&, Entity&, Ts&...>) {
+                fn(*entity, static_cast<Ts&>(*m_cache->getComponent(match, Slots))...);
+            } else {
+                fn(static_cast<Ts&>(*m_cache->getComponent(match, Slots))...);
+            }
+        }
+    }
+
+    QueryCache* m_cache;
+};
+
+} // namespace vroom
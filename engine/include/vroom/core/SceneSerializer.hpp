@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "vroom/core/ComponentRegistry.hpp"
+#include "vroom/core/Scene.hpp"
+
+namespace vroom {
+
+/// \brief Saves scenes to, and loads them from, a binary or a JSON form.
+///
+/// Both forms hold the same things: the scene's entities in parent-before-child order
+/// with their own active state, and the saved data of every component whose type is in
+/// the ComponentRegistry. Components of other types are left out.
+///
+/// The binary form (see SceneFormat.hpp) is what games ship. It is a versioned list of
+/// chunks, one per component type, each holding the type's values back to back, so a
+/// load is a bounds check and one copy per type. The JSON form lists components per
+/// entity, and is meant for hand editing and for diffing scenes in version control.
+///
+/// Loading adds the entities to the scene, which may already hold others, and leaves it
+/// untouched if the input is rejected. Component types a file names but the registry does
+/// not know are skipped with a warning. Neither saving nor loading may happen while the
+/// scene updates.
+class SceneSerializer {
+public:
+    /// \param registry The component types to save and load, which must outlive the serializer.
+    explicit SceneSerializer(const ComponentRegistry& registry) : m_registry(registry) {}
+
+    /// \brief Saves a scene to the binary form.
+    std::vector<char> saveBinary(Scene& scene) const;
+
+    /// \brief Loads the binary form into a scene.
+    /// \return False if the data is not a scene, is of a newer version, or is corrupt.
+    bool loadBinary(Scene& scene, const char* data, size_t size) const;
+
+    /// \brief Saves a scene to the JSON form.
+    nlohmann::json saveJson(Scene& scene) const;
+
+    /// \brief Loads the JSON form into a scene.
+    /// \return False if the JSON is not a scene of a supported version.
+    bool loadJson(Scene& scene, const nlohmann::json& json) const;
+
+    /// \brief Saves a scene to a file, in the JSON form if its extension is .json and the binary form otherwise.
+    /// \return False if the file could not be written.
+    bool saveFile(Scene& scene, const std::filesystem::path& path) const;
+
+    /// \brief Loads a file saved by saveFile() into a scene, memory-mapping binary ones.
+    /// \return False if the file could not be read or was rejected.
+    bool loadFile(Scene& scene, const std::filesystem::path& path) const;
+
+private:
+    const ComponentRegistry& m_registry;
+};
+
+} // namespace vroom
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/ComponentType.hpp"
+
+namespace vroom {
+
+class Scene;
+class JobSystem;
+
+/// \brief Component types a system reads and writes during its update.
+struct SystemAccess {
+    std::vector<ComponentTypeId> reads;
+    std::vector<ComponentTypeId> writes;
+
+    /// \brief Checks whether two systems may not run at the same time.
+    /// They conflict when either one writes a type the other reads or writes.
+    bool conflictsWith(const SystemAccess& other) const;
+};
+
+/// \brief Logic that runs once per frame over the components of a Scene.
+///
+/// A system declares the component types it touches by calling reads() and writes() from
+/// its constructor. The SystemScheduler uses these declarations to run systems that do not
+/// conflict in parallel, so an update must not touch component types it did not declare.
+/// Structural changes (creating or destroying entities, adding or removing components) must
+/// be recorded in an EntityCommandBuffer and submitted to the scene instead.
+class System {
+public:
+    virtual ~System() = default;
+
+    /// \brief Runs the system for one frame.
+    /// \param scene The scene being updated.
+    /// \param deltaTime Time elapsed since the last frame.
+    virtual void update(Scene& scene, float deltaTime) = 0;
+
+    /// \brief Gets the component types this system reads and writes.
+    const SystemAccess& getAccess() const { return m_access; }
+
+protected:
+    /// \brief Declares that update() reads components of types Ts.
+    template <typename... Ts>
+    void reads() {
+        static_assert((std::is_base_of_v<Component, Ts> && ...), "Ts must inherit from Component");
+        (m_access.reads.push_back(componentTypeId<Ts>()), ...);
+    }
+
+    /// \brief Declares that update() modifies components of types Ts.
+    template <typename... Ts>
+    void writes() {
+        static_assert((std::is_base_of_v<Component, Ts> && ...), "Ts must inherit from Component");
+        (m_access.writes.push_back(componentTypeId<Ts>()), ...);
+    }
+
+private:
+    SystemAccess m_access;
+};
+
+/// \brief Runs the systems registered with a Scene, in parallel where their access allows.
+///
+/// Systems that conflict run in the order they were added; systems that do not conflict
+/// may run at the same time on the JobSystem. The dependency graph is rebuilt only when
+/// systems are added.
+class SystemScheduler {
+public:
+    SystemScheduler() = default;
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    /// \brief Creates and registers a system.
+    /// \tparam T The system type. Must inherit from System.
+    /// \param args Arguments forwarded to the system's constructor.
+    /// \return Reference to the new system.
+    template <typename T, typename... Args>
+    T& addSystem(Args&&... args) {
+        static_assert(std::is_base_of_v<System, T>, "T must inherit from System");
+        auto system = std::make_unique<T>(std::forward<Args>(args)...);
+        T& systemRef = *system;
+        m_systems.push_back(std::move(system));
+        m_graphDirty = true;
+        return systemRef;
+    }
+
+    /// \brief Gets the number of registered systems.
+    size_t size() const { return m_systems.size(); }
+
+    /// \brief Runs every system once and waits for all of them to finish.
+    ///
+    /// If systems throw, the remaining ones still run and the first exception is rethrown.
+    /// The calling thread runs jobs while it waits, so this may be called from a job.
+    /// \param scene The scene passed to the systems.
+    /// \param deltaTime Time elapsed since the last frame.
+    /// \param jobs Job system to run systems on, or nullptr to run them in order on this thread.
+    void run(Scene& scene, float deltaTime, JobSystem* jobs);
+
+private:
+    void buildGraph();
+
+    std::vector<std::unique_ptr<System>> m_systems;
+    bool m_graphDirty = false;
+    // For each system, the later systems that must wait for it and how many systems it waits for
+    std::vector<std::vector<size_t>> m_dependents;
+    std::vector<size_t> m_dependencyCounts;
+};
+
+} // namespace vroom
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "vroom/core/Component.hpp"
+#include "vroom/core/TransformStorage.hpp"
+
+namespace vroom {
+
+/// \brief Position, rotation and scale of an entity relative to its parent.
+///
+/// The data lives in the scene's TransformStorage; the component only holds its index.
+/// World matrices are brought up to date at the end of every Scene::update(), or by
+/// Scene::updateTransforms(). Parents without a Transform count as identity.
+/// On an entity that is not part of a scene, the world matrix is the local one.
+class Transform final : public Component {
+public:
+    Transform() = default;
+    ~Transform() override;
+
+    /// \brief Allocates the transform in its scene's storage.
+    void awake() override;
+
+    const glm::vec3& getLocalPosition() const { return m_storage->getPosition(m_index); }
+    const glm::quat& getLocalRotation() const { return m_storage->getRotation(m_index); }
+    const glm::vec3& getLocalScale() const { return m_storage->getScale(m_index); }
+
+    void setLocalPosition(const glm::vec3& position) { m_storage->setPosition(m_index, position); }
+    void setLocalRotation(const glm::quat& rotation) { m_storage->setRotation(m_index, rotation); }
+    void setLocalScale(const glm::vec3& scale) { m_storage->setScale(m_index, scale); }
+
+    /// \brief Gets the matrix that maps from this transform's space to its parent's.
+    const glm::mat4& getLocalMatrix() const { return m_storage->getLocalMatrix(m_index); }
+
+    /// \brief Gets the matrix that maps from this transform's space to world space.
+    const glm::mat4& getWorldMatrix() const {
+        return m_ownStorage ? m_storage->getLocalMatrix(m_index) : m_storage->getWorldMatrix(m_index);
+    }
+
+    /// \brief Gets the world-space position.
+    glm::vec3 getWorldPosition() const {
+        const glm::vec4& translation = getWorldMatrix()[3];
+        return glm::vec3(translation.x, translation.y, translation.z);
+    }
+
+    /// \brief Gets the index of this transform in its TransformStorage.
+    uint32_t getIndex() const { return m_index; }
+
+private:
+    TransformStorage* m_storage = nullptr;
+    std::unique_ptr<TransformStorage> m_ownStorage; // Entities without a scene
+    uint32_t m_index = TransformStorage::InvalidIndex;
+};
+
+} // namespace vroom
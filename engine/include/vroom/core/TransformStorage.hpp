@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "vroom/core/Entity.hpp"
+
+namespace vroom {
+
+class Scene;
+class SceneHierarchy;
+
+/// \brief Holds the data of every Transform in a Scene as parallel arrays.
+///
+/// Each Transform owns one index into the arrays. Changing a local position, rotation or
+/// scale only flags the transform; propagate() then recomputes the world matrices of the
+/// changed subtrees, and only those, walking the scene's SceneHierarchy so parents are
+/// always done before their children. Transforms are also indexed by their owner's entity
+/// slot, so propagation reads only the hierarchy's arrays and these, never the entities.
+/// An entity with several Transforms is propagated through the first one created.
+class TransformStorage {
+public:
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    TransformStorage() = default;
+
+    TransformStorage(const TransformStorage&) = delete;
+    TransformStorage& operator=(const TransformStorage&) = delete;
+
+    /// \brief Allocates an identity transform for an entity.
+    /// \param owner Handle of the entity the transform belongs to.
+    /// \return Index of the new transform.
+    uint32_t create(EntityHandle owner);
+
+    /// \brief Frees a transform's index for reuse.
+    void destroy(uint32_t index);
+
+    /// \brief Gets the index of the transform of the entity in a slot (EntityHandle::index), or InvalidIndex.
+    uint32_t findBySlot(uint32_t slot) const { return slot < m_slotIndices.size() ? m_slotIndices[slot] : InvalidIndex; }
+
+    /// \brief Gets the number of live transforms.
+    size_t size() const { return m_owners.size() - m_freeIndices.size(); }
+
+    const glm::vec3& getPosition(uint32_t index) const { return m_positions[index]; }
+    const glm::quat& getRotation(uint32_t index) const { return m_rotations[index]; }
+    const glm::vec3& getScale(uint32_t index) const { return m_scales[index]; }
+
+    void setPosition(uint32_t index, const glm::vec3& position);
+    void setRotation(uint32_t index, const glm::quat& rotation);
+    void setScale(uint32_t index, const glm::vec3& scale);
+
+    /// \brief Gets the matrix composed from the local position, rotation and scale.
+    const glm::mat4& getLocalMatrix(uint32_t index) const { return m_localMatrices[index]; }
+
+    /// \brief Gets the world matrix as of the last propagate().
+    const glm::mat4& getWorldMatrix(uint32_t index) const { return m_worldMatrices[index]; }
+
+    /// \brief Flags the world matrices of entity and its descendants for recomputation.
+    /// Called for local changes, and by the scene when an entity is reparented.
+    void markDirty(EntityHandle entity);
+
+    /// \brief Recomputes the world matrices of every subtree flagged since the last call.
+    /// \param scene The scene the transforms belong to.
+    /// \return Number of world matrices recomputed.
+    size_t propagate(Scene& scene);
+
+private:
+    /// \brief Recomposes the local matrix after a local change and queues the owner.
+    void onLocalChanged(uint32_t index);
+
+    /// \brief Recomputes the world matrices of the hierarchy range [begin, end), which is one subtree.
+    size_t propagateSubtree(const SceneHierarchy& hierarchy, size_t begin, size_t end);
+
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    // Composed as soon as a local value changes, so readers never write
+    std::vector<glm::mat4> m_localMatrices;
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<EntityHandle> m_owners;
+    std::vector<uint8_t> m_queued; // Whether the owner is in m_dirtyEntities
+    std::vector<uint32_t> m_freeIndices;
+    std::vector<uint32_t> m_slotIndices; // Indexed by EntityHandle::index
+
+    std::vector<EntityHandle> m_dirtyEntities;
+    // Scratch for propagate(), kept to avoid allocating every frame
+    std::vector<uint32_t> m_dirtyPositions;
+    std::vector<uint32_t> m_parentWorlds;
+};
+
+} // namespace vroom
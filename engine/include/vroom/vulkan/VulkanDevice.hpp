@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <filesystem>
 #include <vector>
 #include <optional>
 #include <string>
@@ -27,7 +28,12 @@ struct SwapChainSupportDetails {
 
 class VulkanDevice {
 public:
-    VulkanDevice(GLFWwindow* window);
+    /**
+     * @param window The window to present to.
+     * @param pipelineCachePath File the pipeline cache is seeded from and saved to on
+     *        destruction. Empty keeps the cache in memory only.
+     */
+    VulkanDevice(GLFWwindow* window, std::filesystem::path pipelineCachePath = {});
     ~VulkanDevice();
 
     // Prevent copying
@@ -41,6 +47,7 @@ public:
     VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
     VkQueue getPresentQueue() const { return m_presentQueue; }
     VkCommandPool getCommandPool() const { return m_commandPool; }
+    VkPipelineCache getPipelineCache() const { return m_pipelineCache; }
     
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device) const;
     SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device) const;
@@ -48,6 +55,12 @@ public:
 
     void waitIdle() const { vkDeviceWaitIdle(m_device); }
 
+    /**
+     * @brief Writes the pipeline cache to the cache file, if one was given.
+     * Called automatically on destruction.
+     */
+    void savePipelineCache() const;
+
 private:
     void createInstance();
     void setupDebugMessenger();
@@ -55,6 +68,10 @@ private:
     void pickPhysicalDevice();
     void createLogicalDevice();
     void createCommandPool();
+    void createPipelineCache();
+
+    // Returns the saved cache blob if it was produced by this exact device and driver
+    std::vector<char> loadPipelineCacheData() const;
 
     bool checkValidationLayerSupport();
     std::vector<const char*> getRequiredExtensions();
@@ -79,6 +96,8 @@ private:
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
     VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    std::filesystem::path m_pipelineCachePath;
 
 #ifdef NDEBUG
     const bool enableValidationLayers = false;
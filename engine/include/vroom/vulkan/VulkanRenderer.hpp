@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <filesystem>
 #include <vector>
 #include <memory>
 #include <string>
@@ -15,7 +16,8 @@ namespace vroom {
 
 class VulkanRenderer {
 public:
-    VulkanRenderer(AssetManager& assetManager); // Pass AssetManager
+    // pipelineCachePath persists compiled pipelines between runs; empty disables it
+    VulkanRenderer(AssetManager& assetManager, std::filesystem::path pipelineCachePath = {});
     ~VulkanRenderer();
 
     void init(GLFWwindow* window);
@@ -33,12 +35,13 @@ private:
     void recreateSwapChain();
     void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
 
-    VkShaderModule createShaderModule(const std::vector<char>& code);
+    VkShaderModule createShaderModule(const AssetView& code);
     // Removed readFile as we use AssetManager now
 
     AssetManager& m_assetManager; // Reference to AssetManager
 
     GLFWwindow* m_window = nullptr;
+    std::filesystem::path m_pipelineCachePath;
     
     std::unique_ptr<VulkanDevice> m_device;
     std::unique_ptr<VulkanSwapChain> m_swapChain;
@@ -1,35 +1,358 @@
 #include "vroom/asset/AssetManager.hpp"
+#include "vroom/asset/ShaderAsset.hpp"
 #include "vroom/asset/ShaderCompiler.hpp"
+#include "vroom/logging/LogMacros.hpp"
 
 namespace vroom {
 
 AssetManager::AssetManager() = default;
-AssetManager::~AssetManager() = default;
+
+AssetManager::~AssetManager() {
+    // Jobs reference this manager, so let queued loads finish before members go away
+    if (m_jobSystem) {
+        m_jobSystem->wait(m_asyncLoads);
+    }
+}
 
 void AssetManager::addProvider(std::unique_ptr<AssetProvider> provider) {
     if (provider) {
+        std::unique_lock<std::shared_mutex> lock(m_registryMutex);
         m_providers.push_back(std::move(provider));
     }
 }
 
 void AssetManager::clearProviders() {
-    m_providers.clear();
+    {
+        std::unique_lock<std::shared_mutex> lock(m_registryMutex);
+        m_providers.clear();
+    }
     // Also clear the asset cache as references might be invalid or we want to force reload from new providers
     std::lock_guard<std::mutex> lock(m_assetsMutex);
     m_assets.clear();
+    m_lru.clear();
+    m_residentBytes = 0;
+    ++m_cacheGeneration;
 }
 
 void AssetManager::setShaderCompiler(std::unique_ptr<ShaderCompiler> compiler) {
     m_compiler = std::move(compiler);
 }
 
-std::optional<std::vector<char>> AssetManager::readRawAsset(const std::filesystem::path& path) const {
+std::optional<AssetView> AssetManager::readRawAsset(const std::filesystem::path& path) const {
+    std::shared_lock<std::shared_mutex> lock(m_registryMutex);
     for (const auto& provider : m_providers) {
         if (provider->exists(path)) {
-            return provider->readFile(path);
+            return provider->viewFile(path);
         }
     }
     return std::nullopt;
 }
 
+std::shared_ptr<Asset> AssetManager::findCached(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    return touchCached(path);
+}
+
+std::shared_ptr<Asset> AssetManager::touchCached(const std::string& path) {
+    auto it = m_assets.find(path);
+    if (it == m_assets.end()) {
+        return nullptr;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    m_cacheHits++;
+    return it->second.asset;
+}
+
+std::shared_ptr<Asset> AssetManager::insertCached(const std::string& path, std::shared_ptr<Asset> asset, bool replace) {
+    auto it = m_assets.find(path);
+    if (it != m_assets.end()) {
+        if (!replace) {
+            // Another load got here first, share its asset
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+            return it->second.asset;
+        }
+        eraseCached(it);
+    }
+
+    m_lru.push_front(path);
+    CacheEntry entry;
+    entry.memoryUsage = asset->getMemoryUsage();
+    entry.lruPosition = m_lru.begin();
+    entry.asset = asset;
+    m_residentBytes += entry.memoryUsage;
+    m_assets.emplace(path, std::move(entry));
+
+    // The caller still holds the new asset, so it survives this pass
+    evictToBudget();
+    return asset;
+}
+
+void AssetManager::eraseCached(std::unordered_map<std::string, CacheEntry>::iterator it) {
+    m_residentBytes -= it->second.memoryUsage;
+    m_lru.erase(it->second.lruPosition);
+    m_assets.erase(it);
+}
+
+void AssetManager::evictToBudget() {
+    if (m_memoryBudget == 0) {
+        return;
+    }
+
+    auto position = m_lru.end();
+    while (m_residentBytes > m_memoryBudget && position != m_lru.begin()) {
+        --position;
+        auto it = m_assets.find(*position);
+
+        // Assets still referenced elsewhere would only be reloaded as duplicates
+        bool pinned = m_pinCounts.find(*position) != m_pinCounts.end();
+        if (pinned || it->second.asset.use_count() > 1) {
+            continue;
+        }
+
+        // Step past the entry before its list node is erased
+        ++position;
+        eraseCached(it);
+        m_evictions++;
+    }
+}
+
+void AssetManager::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    m_memoryBudget = bytes;
+    evictToBudget();
+}
+
+size_t AssetManager::getMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    return m_memoryBudget;
+}
+
+void AssetManager::trimCache() {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    evictToBudget();
+}
+
+void AssetManager::pinAsset(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    m_pinCounts[path]++;
+}
+
+void AssetManager::unpinAsset(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    auto it = m_pinCounts.find(path);
+    if (it == m_pinCounts.end()) {
+        LOG_ENGINE_CLASS_WARNING("unpinAsset called on an asset that is not pinned: " + path);
+        return;
+    }
+    if (--it->second == 0) {
+        m_pinCounts.erase(it);
+        evictToBudget();
+    }
+}
+
+bool AssetManager::resolveOrJoinPending(const std::string& path, const AssetCallback& callback) {
+    std::shared_ptr<Asset> cached;
+    {
+        std::lock_guard<std::mutex> lock(m_assetsMutex);
+        cached = touchCached(path);
+        if (!cached) {
+            auto pending = m_pendingLoads.find(path);
+            if (pending == m_pendingLoads.end()) {
+                return false;
+            }
+            m_coalescedRequests++;
+            pending->second.continuations.push_back(callback);
+            return true;
+        }
+    }
+    callback(cached);
+    return true;
+}
+
+std::shared_ptr<Asset> AssetManager::loadAndCache(std::type_index type, const std::string& path, bool replace) {
+    std::promise<std::shared_ptr<Asset>> promise;
+    uint64_t generation;
+    {
+        std::unique_lock<std::mutex> lock(m_assetsMutex);
+        generation = m_cacheGeneration;
+
+        if (!replace) {
+            if (auto cached = touchCached(path)) {
+                return cached;
+            }
+
+            auto pending = m_pendingLoads.find(path);
+            if (pending != m_pendingLoads.end()) {
+                m_coalescedRequests++;
+                auto result = pending->second.result;
+                lock.unlock();
+                return result.get();
+            }
+
+            m_pendingLoads.emplace(path, PendingLoad{promise.get_future().share(), {}});
+        }
+    }
+
+    std::shared_ptr<Asset> asset;
+    std::exception_ptr error;
+    try {
+        asset = loadUncached(type, path);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::vector<AssetCallback> continuations;
+    {
+        std::lock_guard<std::mutex> lock(m_assetsMutex);
+        // If the cache was reset while we were loading, hand the asset back without caching it
+        if (asset && generation == m_cacheGeneration) {
+            asset = insertCached(path, std::move(asset), replace);
+        }
+
+        if (!replace) {
+            auto pending = m_pendingLoads.find(path);
+            if (pending != m_pendingLoads.end()) {
+                continuations = std::move(pending->second.continuations);
+                m_pendingLoads.erase(pending);
+            }
+        }
+    }
+
+    if (!replace) {
+        if (error) {
+            promise.set_exception(error);
+        } else {
+            promise.set_value(asset);
+        }
+    }
+
+    // Async waiters only ever see the asset or nullptr
+    for (const auto& continuation : continuations) {
+        continuation(asset);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return asset;
+}
+
+std::shared_ptr<Asset> AssetManager::loadUncached(std::type_index type, const std::string& path) {
+    AnyLoader loader;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_registryMutex);
+        auto it = m_loaders.find(type);
+        if (it == m_loaders.end()) {
+            return nullptr;
+        }
+        loader = it->second;
+    }
+
+    auto rawData = readRawAsset(path);
+    if (!rawData) {
+        return nullptr;
+    }
+
+    m_loads++;
+    auto asset = loader(*rawData, path);
+    if (!asset) {
+        m_failedLoads++;
+        return nullptr;
+    }
+
+    asset->setPath(path);
+    return asset;
+}
+
+size_t AssetManager::preloadShaders(const std::vector<std::string>& paths) {
+    if (!m_compiler) {
+        LOG_ENGINE_CLASS_ERROR("No shader compiler available to preload shaders");
+        return 0;
+    }
+
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_assetsMutex);
+        generation = m_cacheGeneration;
+    }
+
+    std::vector<ShaderCompileJob> jobs;
+    std::vector<const std::string*> jobPaths;
+    for (const auto& path : paths) {
+        if (std::filesystem::path(path).extension() == ".spv") {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_assetsMutex);
+            if (m_assets.count(path)) {
+                continue;
+            }
+        }
+        auto rawData = readRawAsset(path);
+        if (!rawData) {
+            continue;
+        }
+        jobs.push_back({path, std::string(rawData->begin(), rawData->end()), shaderStageFromPath(path)});
+        jobPaths.push_back(&path);
+    }
+    if (jobs.empty()) {
+        return 0;
+    }
+
+    auto results = m_compiler->compileBatch(jobs, getJobSystem());
+
+    size_t compiled = 0;
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const std::string& path = *jobPaths[i];
+        m_loads++;
+        if (!results[i].succeeded()) {
+            m_failedLoads++;
+            LOG_ENGINE_CLASS_ERROR("Shader compilation failed for " + path + ":\n" + results[i].diagnostics);
+            continue;
+        }
+        if (!results[i].diagnostics.empty()) {
+            LOG_ENGINE_CLASS_WARNING("Shader compiled with warnings for " + path + ":\n" + results[i].diagnostics);
+        }
+
+        // As in loadAndCache(), a reset during the compile means the results are stale
+        if (generation != m_cacheGeneration) {
+            continue;
+        }
+        auto asset = std::make_shared<ShaderAsset>(std::move(*results[i].binary), jobs[i].stage);
+        asset->setPath(path);
+        insertCached(path, std::move(asset), false);
+        ++compiled;
+    }
+    return compiled;
+}
+
+AssetCacheStats AssetManager::getStats() const {
+    AssetCacheStats stats;
+    stats.cacheHits = m_cacheHits.load();
+    stats.loads = m_loads.load();
+    stats.failedLoads = m_failedLoads.load();
+    stats.coalescedRequests = m_coalescedRequests.load();
+    stats.evictions = m_evictions.load();
+
+    std::lock_guard<std::mutex> lock(m_assetsMutex);
+    stats.residentBytes = m_residentBytes;
+    stats.residentAssets = m_assets.size();
+    return stats;
+}
+
+void AssetManager::setJobSystem(JobSystem* jobs) {
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    m_jobSystem = jobs;
+}
+
+JobSystem& AssetManager::getJobSystem() {
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    if (!m_jobSystem) {
+        m_ownedJobSystem = std::make_unique<JobSystem>();
+        m_jobSystem = m_ownedJobSystem.get();
+    }
+    return *m_jobSystem;
+}
+
 } // namespace vroom
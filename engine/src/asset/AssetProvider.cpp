@@ -1,8 +1,10 @@
 #include "vroom/asset/AssetProvider.hpp"
 #include "vroom/asset/PackageFormat.hpp"
+#include "vroom/asset/MappedFile.hpp"
 #include "vroom/logging/LogMacros.hpp"
 #include <fstream>
 #include <cstring>
+#include <algorithm>
 
 namespace vroom {
 
@@ -38,17 +40,30 @@ std::vector<char> DiskAssetProvider::readFile(const std::filesystem::path& relat
     return {};
 }
 
-PackageAssetProvider::PackageAssetProvider(const std::filesystem::path& packagePath)
+PackageAssetProvider::PackageAssetProvider(const std::filesystem::path& packagePath, PackageAccessMode mode)
     : m_packagePath(packagePath) {
-    
-    std::ifstream file(m_packagePath, std::ios::binary);
-    if (!file.is_open()) {
-        LOG_ENGINE_ERROR("Failed to open package file: " + m_packagePath.string());
-        return;
+
+    if (mode == PackageAccessMode::MemoryMapped) {
+        auto mapping = std::make_shared<const MappedFile>(m_packagePath);
+        if (mapping->isOpen()) {
+            m_packageSize = mapping->size();
+            m_mapping = std::move(mapping);
+        } else {
+            LOG_ENGINE_WARNING("Failed to memory-map package, falling back to stream reads: " + m_packagePath.string());
+        }
+    }
+
+    if (!m_mapping) {
+        std::error_code ec;
+        m_packageSize = std::filesystem::file_size(m_packagePath, ec);
+        if (ec) {
+            LOG_ENGINE_ERROR("Failed to open package file: " + m_packagePath.string());
+            return;
+        }
     }
 
     PackageHeader header;
-    if (!file.read(reinterpret_cast<char*>(&header), sizeof(PackageHeader))) {
+    if (!readAt(0, &header, sizeof(PackageHeader))) {
         LOG_ENGINE_ERROR("Failed to read package header: " + m_packagePath.string());
         return;
     }
@@ -58,45 +73,258 @@ PackageAssetProvider::PackageAssetProvider(const std::filesystem::path& packageP
         return;
     }
 
-    if (header.version != 1) {
-        LOG_ENGINE_ERROR("Unsupported package version: " + std::to_string(header.version));
+    bool mounted = false;
+    switch (header.version) {
+        case PACKAGE_VERSION_1: mounted = mountV1(header.fileCount); break;
+        case PACKAGE_VERSION_2: mounted = mountV2(); break;
+        default:
+            LOG_ENGINE_ERROR("Unsupported package version: " + std::to_string(header.version));
+            return;
+    }
+
+    if (!mounted) {
+        m_toc = {};
+        m_strings = {};
+        m_tocStorage.clear();
+        m_stringStorage.clear();
         return;
     }
 
-    for (uint32_t i = 0; i < header.fileCount; ++i) {
-        PackageFileEntry entry;
-        if (file.read(reinterpret_cast<char*>(&entry), sizeof(PackageFileEntry))) {
-            m_fileTable[entry.path] = {entry.offset, entry.size};
-        } else {
-            LOG_ENGINE_ERROR("Failed to read file entry " + std::to_string(i));
-            break;
+    m_version = header.version;
+}
+
+PackageAssetProvider::~PackageAssetProvider() = default;
+
+bool PackageAssetProvider::readAt(uint64_t offset, void* destination, uint64_t size) const {
+    if (offset > m_packageSize || size > m_packageSize - offset) {
+        return false;
+    }
+
+    if (m_mapping) {
+        std::memcpy(destination, m_mapping->data() + offset, size);
+        return true;
+    }
+
+    std::ifstream file(m_packagePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    return static_cast<bool>(file.read(static_cast<char*>(destination), static_cast<std::streamsize>(size)));
+}
+
+bool PackageAssetProvider::mountV1(uint32_t fileCount) {
+    // v1 has no lookup structure on disk, so convert its entries into the v2 sorted table.
+    // The count is checked against the file before anything is sized from it.
+    uint64_t entriesSize = static_cast<uint64_t>(fileCount) * sizeof(PackageFileEntry);
+    if (entriesSize > m_packageSize - sizeof(PackageHeader)) {
+        LOG_ENGINE_ERROR("Corrupt package file count: " + m_packagePath.string());
+        return false;
+    }
+
+    std::vector<PackageFileEntry> entries(fileCount);
+    if (!readAt(sizeof(PackageHeader), entries.data(), entriesSize)) {
+        LOG_ENGINE_ERROR("Failed to read file entries: " + m_packagePath.string());
+        return false;
+    }
+
+    m_tocStorage.reserve(fileCount);
+    for (const auto& entry : entries) {
+        std::string_view path(entry.path, strnlen(entry.path, sizeof(entry.path)));
+
+        PackageTocEntry tocEntry{};
+        tocEntry.pathOffset = static_cast<uint32_t>(m_stringStorage.size());
+        tocEntry.pathLength = static_cast<uint32_t>(path.size());
+        tocEntry.offset = entry.offset;
+        tocEntry.storedSize = entry.size;
+        tocEntry.size = entry.size;
+        tocEntry.codec = PackageCodec::None;
+
+        for (char c : path) {
+            m_stringStorage.push_back(c == '\\' ? '/' : c);
         }
+        tocEntry.pathHash = hashPackagePath(std::string_view(m_stringStorage.data() + tocEntry.pathOffset, path.size()));
+        m_tocStorage.push_back(tocEntry);
     }
+
+    m_strings = std::string_view(m_stringStorage.data(), m_stringStorage.size());
+    std::sort(m_tocStorage.begin(), m_tocStorage.end(), [this](const PackageTocEntry& a, const PackageTocEntry& b) {
+        if (a.pathHash != b.pathHash) {
+            return a.pathHash < b.pathHash;
+        }
+        return entryPath(a) < entryPath(b);
+    });
+    m_toc = m_tocStorage;
+    return true;
+}
+
+bool PackageAssetProvider::mountV2() {
+    PackageHeaderV2 header;
+    if (!readAt(0, &header, sizeof(PackageHeaderV2))) {
+        LOG_ENGINE_ERROR("Failed to read v2 package header: " + m_packagePath.string());
+        return false;
+    }
+
+    uint64_t tocSize = static_cast<uint64_t>(header.fileCount) * sizeof(PackageTocEntry);
+    if (header.tocOffset > m_packageSize || tocSize > m_packageSize - header.tocOffset ||
+        header.stringTableOffset > m_packageSize || header.stringTableSize > m_packageSize - header.stringTableOffset) {
+        LOG_ENGINE_ERROR("Corrupt package table of contents: " + m_packagePath.string());
+        return false;
+    }
+
+    // Use the table and strings in place when mapped; only copy if the table is misaligned
+    if (m_mapping && header.tocOffset % alignof(PackageTocEntry) == 0) {
+        m_toc = std::span<const PackageTocEntry>(
+            reinterpret_cast<const PackageTocEntry*>(m_mapping->data() + header.tocOffset), header.fileCount);
+        m_strings = std::string_view(m_mapping->data() + header.stringTableOffset, header.stringTableSize);
+        return true;
+    }
+
+    m_tocStorage.resize(header.fileCount);
+    m_stringStorage.resize(header.stringTableSize);
+    if (!readAt(header.tocOffset, m_tocStorage.data(), tocSize) ||
+        !readAt(header.stringTableOffset, m_stringStorage.data(), header.stringTableSize)) {
+        LOG_ENGINE_ERROR("Failed to read package table of contents: " + m_packagePath.string());
+        return false;
+    }
+
+    m_toc = m_tocStorage;
+    m_strings = std::string_view(m_stringStorage.data(), m_stringStorage.size());
+    return true;
+}
+
+std::string_view PackageAssetProvider::entryPath(const PackageTocEntry& entry) const {
+    if (entry.pathOffset > m_strings.size() || entry.pathLength > m_strings.size() - entry.pathOffset) {
+        return {};
+    }
+    return m_strings.substr(entry.pathOffset, entry.pathLength);
+}
+
+const PackageTocEntry* PackageAssetProvider::findEntry(const std::filesystem::path& relativePath) const {
+    std::string key = relativePath.generic_string();
+    uint64_t hash = hashPackagePath(key);
+
+    auto it = std::lower_bound(m_toc.begin(), m_toc.end(), hash, [](const PackageTocEntry& entry, uint64_t value) {
+        return entry.pathHash < value;
+    });
+
+    // Walk the (almost always single-element) run of entries sharing this hash
+    for (; it != m_toc.end() && it->pathHash == hash; ++it) {
+        if (entryPath(*it) == key) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+size_t PackageAssetProvider::getFileCount() const {
+    return m_toc.size();
 }
 
 bool PackageAssetProvider::exists(const std::filesystem::path& relativePath) const {
-    return m_fileTable.find(relativePath.string()) != m_fileTable.end();
+    return findEntry(relativePath) != nullptr;
 }
 
 std::vector<char> PackageAssetProvider::readFile(const std::filesystem::path& relativePath) const {
-    auto it = m_fileTable.find(relativePath.string());
-    if (it == m_fileTable.end()) {
+    const PackageTocEntry* entry = findEntry(relativePath);
+    if (!entry) {
         return {};
     }
 
-    std::ifstream file(m_packagePath, std::ios::binary);
-    if (!file.is_open()) {
-        return {};
+    if (entry->codec != PackageCodec::None) {
+        return readCompressed(*entry);
     }
 
-    file.seekg(it->second.offset, std::ios::beg);
-    
-    std::vector<char> buffer(it->second.size);
-    if (file.read(buffer.data(), it->second.size)) {
+    std::vector<char> buffer(entry->size);
+    if (readAt(entry->offset, buffer.data(), entry->size)) {
         return buffer;
     }
 
     return {};
 }
 
+AssetView PackageAssetProvider::viewFile(const std::filesystem::path& relativePath) const {
+    if (!m_mapping) {
+        return AssetProvider::viewFile(relativePath);
+    }
+
+    const PackageTocEntry* entry = findEntry(relativePath);
+    if (!entry || entry->offset > m_packageSize || entry->storedSize > m_packageSize - entry->offset) {
+        return {};
+    }
+
+    // Compressed entries can't be viewed in place; hand out the decompressed buffer instead
+    if (entry->codec != PackageCodec::None) {
+        return AssetView(readCompressed(*entry));
+    }
+
+    // Raw entries are stored as is; any other size in a corrupt TOC would run past the bounds checked above
+    if (entry->size != entry->storedSize) {
+        return {};
+    }
+
+    std::span<const char> bytes(m_mapping->data() + entry->offset, entry->size);
+    return AssetView(bytes, m_mapping);
+}
+
+std::vector<char> PackageAssetProvider::readCompressed(const PackageTocEntry& entry) const {
+    // Decompress straight out of the mapping when possible, otherwise stage the stored bytes
+    std::vector<char> stored;
+    const char* source = nullptr;
+    if (m_mapping && entry.offset <= m_packageSize && entry.storedSize <= m_packageSize - entry.offset) {
+        source = m_mapping->data() + entry.offset;
+    } else {
+        stored.resize(entry.storedSize);
+        if (!readAt(entry.offset, stored.data(), entry.storedSize)) {
+            return {};
+        }
+        source = stored.data();
+    }
+
+    // The TOC records the uncompressed size, so the destination is allocated exactly once
+    std::vector<char> buffer(entry.size);
+    switch (entry.codec) {
+        case PackageCodec::LZ4:
+            if (lz4Decompress(source, entry.storedSize, buffer.data(), buffer.size())) {
+                return buffer;
+            }
+            break;
+        default:
+            LOG_ENGINE_ERROR("Unsupported package codec " + std::to_string(static_cast<uint32_t>(entry.codec)) +
+                             " for entry: " + std::string(entryPath(entry)));
+            return {};
+    }
+
+    LOG_ENGINE_ERROR("Failed to decompress package entry: " + std::string(entryPath(entry)));
+    return {};
+}
+
+bool PackageAssetProvider::verifyChecksums() const {
+    if (m_version < PACKAGE_VERSION_2) {
+        return true;
+    }
+
+    std::vector<char> buffer;
+    for (const auto& entry : m_toc) {
+        const char* data = nullptr;
+        if (m_mapping && entry.offset <= m_packageSize && entry.storedSize <= m_packageSize - entry.offset) {
+            data = m_mapping->data() + entry.offset;
+        } else {
+            buffer.resize(entry.storedSize);
+            if (!readAt(entry.offset, buffer.data(), entry.storedSize)) {
+                LOG_ENGINE_ERROR("Failed to read package entry: " + std::string(entryPath(entry)));
+                return false;
+            }
+            data = buffer.data();
+        }
+
+        if (hashPackageData(data, entry.storedSize) != entry.checksum) {
+            LOG_ENGINE_ERROR("Checksum mismatch for package entry: " + std::string(entryPath(entry)));
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace vroom
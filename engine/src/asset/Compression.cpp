@@ -0,0 +1,180 @@
+#include "vroom/asset/Compression.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace vroom {
+
+namespace {
+
+// LZ4 block format constraints
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;  // The last 5 bytes are always literals
+constexpr size_t MF_LIMIT = 12;      // The last match must start at least 12 bytes before the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_LOG = 16;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Writes the 255-run encoding of a length that overflowed its 4-bit token field
+inline bool writeLength(uint8_t*& op, const uint8_t* oend, size_t length) {
+    while (length >= 255) {
+        if (op >= oend) return false;
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= oend) return false;
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+inline bool writeLiterals(uint8_t*& op, const uint8_t* oend, uint8_t* token, const uint8_t* literals, size_t length) {
+    if (length >= 15) {
+        *token = 15 << 4;
+        if (!writeLength(op, oend, length - 15)) return false;
+    } else {
+        *token = static_cast<uint8_t>(length << 4);
+    }
+    if (length > static_cast<size_t>(oend - op)) return false;
+    std::memcpy(op, literals, length);
+    op += length;
+    return true;
+}
+
+} // namespace
+
+size_t lz4Compress(const char* source, size_t sourceSize, char* destination, size_t destinationCapacity) {
+    const auto* src = reinterpret_cast<const uint8_t*>(source);
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* iend = src + sourceSize;
+
+    auto* op = reinterpret_cast<uint8_t*>(destination);
+    const uint8_t* oend = op + destinationCapacity;
+
+    if (sourceSize >= MF_LIMIT + 1) {
+        const uint8_t* matchStartLimit = iend - MF_LIMIT;
+        const uint8_t* matchEndLimit = iend - LAST_LITERALS;
+        std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+
+        while (ip <= matchStartLimit) {
+            uint32_t sequence = read32(ip);
+            uint32_t hash = hashSequence(sequence);
+            const uint8_t* ref = src + table[hash];
+            table[hash] = static_cast<uint32_t>(ip - src);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            size_t matchLength = MIN_MATCH;
+            while (ip + matchLength < matchEndLimit && ip[matchLength] == ref[matchLength]) {
+                ++matchLength;
+            }
+
+            if (op >= oend) return 0;
+            uint8_t* token = op++;
+            if (!writeLiterals(op, oend, token, anchor, static_cast<size_t>(ip - anchor))) return 0;
+
+            if (oend - op < 2) return 0;
+            auto offset = static_cast<uint16_t>(ip - ref);
+            *op++ = static_cast<uint8_t>(offset & 0xFF);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+
+            size_t encodedMatch = matchLength - MIN_MATCH;
+            if (encodedMatch >= 15) {
+                *token |= 15;
+                if (!writeLength(op, oend, encodedMatch - 15)) return 0;
+            } else {
+                *token |= static_cast<uint8_t>(encodedMatch);
+            }
+
+            ip += matchLength;
+            anchor = ip;
+        }
+    }
+
+    // Final sequence: remaining literals only
+    if (op >= oend) return 0;
+    uint8_t* token = op++;
+    if (!writeLiterals(op, oend, token, anchor, static_cast<size_t>(iend - anchor))) return 0;
+
+    return static_cast<size_t>(op - reinterpret_cast<uint8_t*>(destination));
+}
+
+bool lz4Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize) {
+    const auto* ip = reinterpret_cast<const uint8_t*>(source);
+    const uint8_t* iend = ip + sourceSize;
+    auto* dst = reinterpret_cast<uint8_t*>(destination);
+    uint8_t* op = dst;
+    const uint8_t* oend = dst + destinationSize;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return false;
+                b = *ip++;
+                literalLength += b;
+            } while (b == 255);
+        }
+
+        if (literalLength > static_cast<size_t>(iend - ip) || literalLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == iend) {
+            break; // Last sequence has no match part
+        }
+
+        if (iend - ip < 2) return false;
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) return false;
+                b = *ip++;
+                matchLength += b;
+            } while (b == 255);
+        }
+        matchLength += MIN_MATCH;
+
+        if (matchLength > static_cast<size_t>(oend - op)) return false;
+
+        const uint8_t* match = op - offset;
+        if (offset >= matchLength) {
+            std::memcpy(op, match, matchLength);
+            op += matchLength;
+        } else {
+            // Overlapping copy repeats the last `offset` bytes
+            for (size_t i = 0; i < matchLength; ++i) {
+                *op++ = match[i];
+            }
+        }
+    }
+
+    return op == oend;
+}
+
+} // namespace vroom
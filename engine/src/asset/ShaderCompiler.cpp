@@ -1,14 +1,103 @@
 #include "vroom/asset/ShaderCompiler.hpp"
+#include "vroom/core/Hash.hpp"
+#include "vroom/core/JobSystem.hpp"
 #include "vroom/logging/LogMacros.hpp"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <array>
+#include <atomic>
+#include <random>
 #include <sstream>
 #include <iostream> // For popen/pclose
 
 namespace vroom {
 
+namespace {
+
+// Runs a command and returns its combined stdout/stderr, or nullopt if it could not be started
+std::optional<std::string> runCommand(const std::string& command, int& returnCode) {
+    FILE* pipe = popen((command + " 2>&1").c_str(), "r");
+    if (!pipe) {
+        return std::nullopt;
+    }
+
+    std::string output;
+    char buffer[128];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        output += buffer;
+    }
+
+    returnCode = pclose(pipe);
+    return output;
+}
+
+// Cached binaries are prefixed with this header so truncated or foreign files are rejected
+struct ShaderCacheHeader {
+    char magic[4] = {'V', 'R', 'S', 'C'}; // VRoom Shader Cache
+    uint32_t version = 1;
+    uint64_t size = 0;
+    uint64_t checksum = 0;
+};
+
+// Options that shape glslc's output besides the stage, which cache keys hold separately.
+// They are part of the compiler identity, so changing them invalidates cached binaries.
+constexpr const char* GLSLC_OPTIONS = "--target-env=vulkan1.0";
+
+std::string toHex(uint64_t value) {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[value & 0xF];
+        value >>= 4;
+    }
+    return hex;
+}
+
+// Unique per call, in this process and across processes sharing a directory: a random
+// per-process token, then a per-process counter (unique across threads too)
+std::string uniqueTempSuffix() {
+    static const uint64_t processToken = std::random_device{}();
+    static std::atomic<uint64_t> counter{0};
+    return toHex(processToken) + "_" + std::to_string(counter++);
+}
+
+} // namespace
+
+ShaderCompileResult ShaderCompiler::compileWithDiagnostics(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    ShaderCompileResult result;
+    result.binary = compile(sourcePath, sourceCode, stage);
+    if (!result.binary) {
+        result.diagnostics = "Compilation failed: " + sourcePath.string();
+    }
+    return result;
+}
+
+std::vector<ShaderCompileResult> ShaderCompiler::compileBatch(const std::vector<ShaderCompileJob>& jobs, JobSystem& jobSystem) {
+    // Each job writes only its own slot, so results needs no locking
+    std::vector<ShaderCompileResult> results(jobs.size());
+    jobSystem.parallelFor(jobs.size(), [this, &jobs, &results](size_t index) {
+        const auto& job = jobs[index];
+        results[index] = compileWithDiagnostics(job.sourcePath, job.sourceCode, job.stage);
+    });
+    return results;
+}
+
+std::optional<std::vector<char>> ShaderCompiler::reportResult(const std::filesystem::path& sourcePath, ShaderCompileResult result) const {
+    if (!result.succeeded()) {
+        LOG_ENGINE_ERROR("Shader compilation failed for " + sourcePath.string() + ":\n" + result.diagnostics);
+    } else if (!result.diagnostics.empty()) {
+        LOG_ENGINE_WARNING("Shader compiled with warnings for " + sourcePath.string() + ":\n" + result.diagnostics);
+    }
+    return std::move(result.binary);
+}
+
 SystemShaderCompiler::SystemShaderCompiler() {
     // We could check if glslc is available here
 }
@@ -18,22 +107,17 @@ std::optional<std::vector<char>> SystemShaderCompiler::compile(
     const std::string& sourceCode,
     ShaderStage stage
 ) {
-    // 1. Write source to temporary file
-    auto tempDir = std::filesystem::temp_directory_path();
-    auto tempSourcePath = tempDir / ("vroom_shader_temp_" + std::to_string(std::hash<std::string>{}(sourcePath.string())) + ".glsl");
-    auto tempSpvPath = tempSourcePath;
-    tempSpvPath.replace_extension(".spv");
+    return reportResult(sourcePath, compileWithDiagnostics(sourcePath, sourceCode, stage));
+}
 
-    {
-        std::ofstream out(tempSourcePath);
-        if (!out.is_open()) {
-            LOG_ENGINE_ERROR("Failed to create temporary shader source file: " + tempSourcePath.string());
-            return std::nullopt;
-        }
-        out << sourceCode;
-    }
+ShaderCompileResult SystemShaderCompiler::compileWithDiagnostics(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    ShaderCompileResult result;
 
-    // 2. Construct command
+    // 1. Pick the stage flag
     std::string stageFlag;
     switch (stage) {
         case ShaderStage::Vertex: stageFlag = "vert"; break;
@@ -42,57 +126,217 @@ std::optional<std::vector<char>> SystemShaderCompiler::compile(
         case ShaderStage::Geometry: stageFlag = "geom"; break;
         case ShaderStage::TessellationControl: stageFlag = "tesc"; break;
         case ShaderStage::TessellationEvaluation: stageFlag = "tese"; break;
-        default: 
-            LOG_ENGINE_ERROR("Unknown shader stage for compilation.");
-            return std::nullopt;
+        default:
+            result.diagnostics = "Unknown shader stage for compilation: " + sourcePath.string();
+            return result;
     }
 
-    std::string command = "glslc -fshader-stage=" + stageFlag + " -o \"" + tempSpvPath.string() + "\" \"" + tempSourcePath.string() + "\"";
+    // 2. Write source to temporary file
+    // Names must be unique per call: the same shader can be compiled concurrently, and
+    // other processes share the temp directory
+    auto tempDir = std::filesystem::temp_directory_path();
+    auto tempSourcePath = tempDir / ("vroom_shader_temp_" + uniqueTempSuffix() + ".glsl");
+    auto tempSpvPath = tempSourcePath;
+    tempSpvPath.replace_extension(".spv");
+
+    {
+        std::ofstream out(tempSourcePath);
+        if (!out.is_open()) {
+            result.diagnostics = "Failed to create temporary shader source file: " + tempSourcePath.string();
+            return result;
+        }
+        out << sourceCode;
+    }
+
+    std::string command = std::string("glslc ") + GLSLC_OPTIONS + " -fshader-stage=" + stageFlag + " -o \"" + tempSpvPath.string() + "\" \"" + tempSourcePath.string() + "\"";
 
     // 3. Execute command
-    std::string output;
-    bool success = false;
-    
     // Using popen to capture output (cross-platform enough for Unix/macOS, might need adjustment for Windows)
-    FILE* pipe = popen((command + " 2>&1").c_str(), "r");
-    if (!pipe) {
-        LOG_ENGINE_ERROR("Failed to run glslc command.");
+    int returnCode = -1;
+    auto output = runCommand(command, returnCode);
+    std::filesystem::remove(tempSourcePath);
+    if (!output) {
+        result.diagnostics = "Failed to run glslc command for: " + sourcePath.string();
+        return result;
+    }
+    // glslc reports warnings on success too
+    result.diagnostics = std::move(*output);
+
+    if (returnCode != 0) {
+        return result;
+    }
+
+    // 4. Read result
+    {
+        std::ifstream spvFile(tempSpvPath, std::ios::binary | std::ios::ate);
+        if (!spvFile.is_open()) {
+            result.diagnostics += "Failed to read compiled SPIR-V file: " + tempSpvPath.string();
+            return result;
+        }
+
+        size_t size = spvFile.tellg();
+        std::vector<char> spvData(size);
+        spvFile.seekg(0, std::ios::beg);
+        spvFile.read(spvData.data(), size);
+        result.binary = std::move(spvData);
+    }
+
+    // 5. Cleanup
+    std::filesystem::remove(tempSpvPath);
+
+    return result;
+}
+
+std::string SystemShaderCompiler::getIdentity() const {
+    std::call_once(m_identityOnce, [this]() {
+        int returnCode = -1;
+        auto version = runCommand("glslc --version", returnCode);
+        // The banner lists shaderc, glslang and SPIRV-Tools versions and the default target env
+        m_identity = std::string("glslc\n") + GLSLC_OPTIONS + "\n" + (returnCode == 0 && version ? *version : std::string());
+    });
+    return m_identity;
+}
+
+CachingShaderCompiler::CachingShaderCompiler(std::unique_ptr<ShaderCompiler> compiler, std::filesystem::path cacheDirectory)
+    : m_compiler(std::move(compiler)), m_cacheDirectory(std::move(cacheDirectory)) {
+    m_identity = m_compiler->getIdentity();
+}
+
+std::filesystem::path CachingShaderCompiler::getCachePath(const std::string& sourceCode, ShaderStage stage) const {
+    // Fields are null-separated so neighbouring values can't run into each other
+    std::string key = m_identity;
+    key += '\0';
+    key += std::to_string(static_cast<int>(stage));
+    key += '\0';
+    key += sourceCode;
+    return m_cacheDirectory / (toHex(hashBytes(key.data(), key.size())) + ".spv");
+}
+
+std::optional<std::vector<char>> CachingShaderCompiler::compile(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    return reportResult(sourcePath, compileWithDiagnostics(sourcePath, sourceCode, stage));
+}
+
+ShaderCompileResult CachingShaderCompiler::compileWithDiagnostics(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    auto cachePath = getCachePath(sourceCode, stage);
+    if (auto cached = readCacheEntry(cachePath)) {
+        LOG_ENGINE_DEBUG("Loaded cached shader binary for: " + sourcePath.string());
+        return {std::move(cached), {}};
+    }
+
+    auto result = m_compiler->compileWithDiagnostics(sourcePath, sourceCode, stage);
+    if (result.binary) {
+        writeCacheEntry(cachePath, *result.binary);
+    }
+    return result;
+}
+
+std::vector<ShaderCompileResult> CachingShaderCompiler::compileBatch(const std::vector<ShaderCompileJob>& jobs, JobSystem& jobSystem) {
+    std::vector<ShaderCompileResult> results(jobs.size());
+    std::vector<std::filesystem::path> cachePaths(jobs.size());
+    std::vector<ShaderCompileJob> misses;
+    std::vector<size_t> missIndices;
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        cachePaths[i] = getCachePath(jobs[i].sourceCode, jobs[i].stage);
+        if (auto cached = readCacheEntry(cachePaths[i])) {
+            results[i].binary = std::move(cached);
+        } else {
+            misses.push_back(jobs[i]);
+            missIndices.push_back(i);
+        }
+    }
+
+    if (misses.empty()) {
+        return results;
+    }
+
+    LOG_ENGINE_INFO("Compiling " + std::to_string(misses.size()) + " of " + std::to_string(jobs.size()) + " shaders (the rest are cached)");
+    auto compiled = m_compiler->compileBatch(misses, jobSystem);
+    for (size_t i = 0; i < compiled.size(); ++i) {
+        size_t index = missIndices[i];
+        if (compiled[i].binary) {
+            writeCacheEntry(cachePaths[index], *compiled[i].binary);
+        }
+        results[index] = std::move(compiled[i]);
+    }
+    return results;
+}
+
+std::optional<std::vector<char>> CachingShaderCompiler::readCacheEntry(const std::filesystem::path& path) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
         return std::nullopt;
     }
 
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
+    ShaderCacheHeader header;
+    ShaderCacheHeader expected;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) {
+        LOG_ENGINE_WARNING("Ignoring invalid shader cache entry: " + path.string());
+        return std::nullopt;
     }
-    
-    int returnCode = pclose(pipe);
-    success = (returnCode == 0);
 
-    if (!success) {
-        LOG_ENGINE_ERROR("Shader compilation failed:\n" + output);
-        // Clean up source
-        std::filesystem::remove(tempSourcePath);
+    // The size is untrusted; a torn or foreign file must not make us allocate whatever it says
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    if (error || header.size > fileSize - sizeof(header)) {
+        LOG_ENGINE_WARNING("Ignoring truncated shader cache entry: " + path.string());
         return std::nullopt;
     }
 
-    // 4. Read result
-    std::ifstream spvFile(tempSpvPath, std::ios::binary | std::ios::ate);
-    if (!spvFile.is_open()) {
-        LOG_ENGINE_ERROR("Failed to read compiled SPIR-V file: " + tempSpvPath.string());
-         std::filesystem::remove(tempSourcePath);
+    std::vector<char> binary(header.size);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file || hashBytes(binary.data(), binary.size()) != header.checksum) {
+        LOG_ENGINE_WARNING("Ignoring corrupted shader cache entry: " + path.string());
         return std::nullopt;
     }
+    return binary;
+}
 
-    size_t size = spvFile.tellg();
-    std::vector<char> spvData(size);
-    spvFile.seekg(0, std::ios::beg);
-    spvFile.read(spvData.data(), size);
+void CachingShaderCompiler::writeCacheEntry(const std::filesystem::path& path, const std::vector<char>& binary) const {
+    std::error_code error;
+    std::filesystem::create_directories(m_cacheDirectory, error);
+    if (error) {
+        LOG_ENGINE_WARNING("Failed to create shader cache directory: " + m_cacheDirectory.string());
+        return;
+    }
 
-    // 5. Cleanup
-    std::filesystem::remove(tempSourcePath);
-    std::filesystem::remove(tempSpvPath);
+    // Write to a private temporary name and rename, so concurrent writers and readers
+    // never observe a partial file. Other processes may share the cache directory.
+    auto tempPath = path;
+    tempPath += ".tmp" + uniqueTempSuffix();
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_ENGINE_WARNING("Failed to write shader cache entry: " + path.string());
+            return;
+        }
 
-    return spvData;
+        ShaderCacheHeader header;
+        header.size = binary.size();
+        header.checksum = hashBytes(binary.data(), binary.size());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+        if (!out) {
+            LOG_ENGINE_WARNING("Failed to write shader cache entry: " + path.string());
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+    }
 }
 
 } // namespace vroom
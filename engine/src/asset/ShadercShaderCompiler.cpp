@@ -0,0 +1,103 @@
+#if defined(VROOM_WITH_SHADERC)
+
+#include "vroom/asset/ShaderCompiler.hpp"
+#include "vroom/logging/LogMacros.hpp"
+
+#include <shaderc/shaderc.h>
+
+#ifndef VROOM_SHADERC_SDK_VERSION
+#define VROOM_SHADERC_SDK_VERSION "unknown"
+#endif
+
+namespace vroom {
+
+namespace {
+
+bool toShadercKind(ShaderStage stage, shaderc_shader_kind& kind) {
+    switch (stage) {
+        case ShaderStage::Vertex: kind = shaderc_vertex_shader; return true;
+        case ShaderStage::Fragment: kind = shaderc_fragment_shader; return true;
+        case ShaderStage::Compute: kind = shaderc_compute_shader; return true;
+        case ShaderStage::Geometry: kind = shaderc_geometry_shader; return true;
+        case ShaderStage::TessellationControl: kind = shaderc_tess_control_shader; return true;
+        case ShaderStage::TessellationEvaluation: kind = shaderc_tess_evaluation_shader; return true;
+        default: return false;
+    }
+}
+
+} // namespace
+
+// shaderc_compiler_t is safe to share between threads; options and results are per call
+struct ShadercShaderCompiler::Impl {
+    shaderc_compiler_t compiler = nullptr;
+};
+
+ShadercShaderCompiler::ShadercShaderCompiler() : m_impl(std::make_unique<Impl>()) {
+    m_impl->compiler = shaderc_compiler_initialize();
+    if (!m_impl->compiler) {
+        LOG_ENGINE_ERROR("Failed to initialize shaderc compiler.");
+    }
+}
+
+ShadercShaderCompiler::~ShadercShaderCompiler() {
+    if (m_impl->compiler) {
+        shaderc_compiler_release(m_impl->compiler);
+    }
+}
+
+std::optional<std::vector<char>> ShadercShaderCompiler::compile(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    return reportResult(sourcePath, compileWithDiagnostics(sourcePath, sourceCode, stage));
+}
+
+ShaderCompileResult ShadercShaderCompiler::compileWithDiagnostics(
+    const std::filesystem::path& sourcePath,
+    const std::string& sourceCode,
+    ShaderStage stage
+) {
+    ShaderCompileResult result;
+    if (!m_impl->compiler) {
+        result.diagnostics = "shaderc compiler is not initialized.";
+        return result;
+    }
+
+    shaderc_shader_kind kind;
+    if (!toShadercKind(stage, kind)) {
+        result.diagnostics = "Unknown shader stage for compilation.";
+        return result;
+    }
+
+    // Default options match a plain glslc invocation: Vulkan 1.0 target, no optimization
+    shaderc_compile_options_t options = shaderc_compile_options_initialize();
+    std::string fileName = sourcePath.string();
+    shaderc_compilation_result_t compilation = shaderc_compile_into_spv(
+        m_impl->compiler, sourceCode.data(), sourceCode.size(), kind, fileName.c_str(), "main", options);
+    shaderc_compile_options_release(options);
+
+    // Holds errors on failure and warnings on success
+    if (const char* message = shaderc_result_get_error_message(compilation)) {
+        result.diagnostics = message;
+    }
+    if (shaderc_result_get_compilation_status(compilation) == shaderc_compilation_status_success) {
+        const char* bytes = shaderc_result_get_bytes(compilation);
+        result.binary.emplace(bytes, bytes + shaderc_result_get_length(compilation));
+    }
+
+    shaderc_result_release(compilation);
+    return result;
+}
+
+std::string ShadercShaderCompiler::getIdentity() const {
+    unsigned int version = 0;
+    unsigned int revision = 0;
+    shaderc_get_spv_version(&version, &revision);
+    return std::string("shaderc ") + VROOM_SHADERC_SDK_VERSION + "\nspv " + std::to_string(version) + "."
+        + std::to_string(revision) + "\ndefault options";
+}
+
+} // namespace vroom
+
+#endif // VROOM_WITH_SHADERC
@@ -1,11 +1,23 @@
 #include "vroom/core/Component.hpp"
 #include "vroom/core/Entity.hpp"
 
+#include <atomic>
+
 namespace vroom {
 
+namespace detail {
+ComponentTypeId nextComponentTypeId() {
+    static std::atomic<ComponentTypeId> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace detail
+
 void Component::setEnabled(bool enabled) {
     if (m_enabled != enabled) {
         m_enabled = enabled;
+        if (m_entity) {
+            m_entity->onComponentStateChanged(*this);
+        }
         
         // Only trigger callbacks if the Entity allows it (active or null)
         // In Unity, if GameObject is inactive, enabling a component doesn't trigger OnEnable.
@@ -23,6 +35,13 @@ void Component::setEnabled(bool enabled) {
     }
 }
 
+void Component::markStarted() {
+    m_hasStarted = true;
+    if (m_entity) {
+        m_entity->onComponentStateChanged(*this);
+    }
+}
+
 SceneManager* Component::getSceneManager() const {
     if (m_entity) {
         return m_entity->getSceneManager();
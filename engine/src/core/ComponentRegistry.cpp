@@ -0,0 +1,74 @@
+#include "vroom/core/ComponentRegistry.hpp"
+#include "vroom/core/Transform.hpp"
+
+#include <algorithm>
+
+namespace vroom {
+
+namespace {
+
+struct TransformData {
+    float position[3];
+    float rotation[4]; // x, y, z, w
+    float scale[3];
+};
+
+void to_json(nlohmann::json& json, const TransformData& data) {
+    json = {
+        {"position", data.position},
+        {"rotation", data.rotation},
+        {"scale", data.scale},
+    };
+}
+
+void from_json(const nlohmann::json& json, TransformData& data) {
+    for (int i = 0; i < 3; ++i) {
+        data.position[i] = json.at("position").at(i).get<float>();
+        data.scale[i] = json.at("scale").at(i).get<float>();
+    }
+    for (int i = 0; i < 4; ++i) {
+        data.rotation[i] = json.at("rotation").at(i).get<float>();
+    }
+}
+
+} // namespace
+
+void ComponentRegistry::registerBuiltins() {
+    registerType<Transform, TransformData>(
+        "Transform",
+        [](const Transform& transform) {
+            const glm::vec3& position = transform.getLocalPosition();
+            const glm::quat& rotation = transform.getLocalRotation();
+            const glm::vec3& scale = transform.getLocalScale();
+            return TransformData{
+                {position.x, position.y, position.z},
+                {rotation.x, rotation.y, rotation.z, rotation.w},
+                {scale.x, scale.y, scale.z},
+            };
+        },
+        [](Transform& transform, const TransformData& data) {
+            transform.setLocalPosition(glm::vec3(data.position[0], data.position[1], data.position[2]));
+            transform.setLocalRotation(glm::quat(data.rotation[3], data.rotation[0], data.rotation[1], data.rotation[2]));
+            transform.setLocalScale(glm::vec3(data.scale[0], data.scale[1], data.scale[2]));
+        });
+}
+
+const ComponentTypeInfo* ComponentRegistry::find(std::string_view name) const {
+    auto it = std::find_if(m_types.begin(), m_types.end(), [&](const ComponentTypeInfo& info) {
+        return info.name == name;
+    });
+    return it != m_types.end() ? &*it : nullptr;
+}
+
+void ComponentRegistry::add(ComponentTypeInfo info) {
+    auto it = std::find_if(m_types.begin(), m_types.end(), [&](const ComponentTypeInfo& existing) {
+        return existing.name == info.name;
+    });
+    if (it != m_types.end()) {
+        *it = std::move(info);
+    } else {
+        m_types.push_back(std::move(info));
+    }
+}
+
+} // namespace vroom
@@ -21,33 +21,33 @@ Engine::Engine(const EngineConfig& config)
     : m_config(config), m_isRunning(false) {
     LOG_ENGINE_INFO("Initializing VROOM Engine v" + Version::getVersionString() + " (" + Version::GIT_HASH + ")");
     
+    // Initialize the job system shared by the subsystems
+    m_jobSystem = std::make_unique<JobSystem>();
+    LOG_ENGINE_INFO("Job system started with " + std::to_string(m_jobSystem->getThreadCount()) + " workers");
+
     // Initialize Asset Manager
     m_assetManager = std::make_unique<AssetManager>();
+    m_assetManager->setJobSystem(m_jobSystem.get());
     
-    // Initialize default shader compiler
-    m_assetManager->setShaderCompiler(std::make_unique<SystemShaderCompiler>());
+    auto cacheDir = m_config.cacheDirectory ? std::filesystem::path(m_config.cacheDirectory)
+                                            : Platform::getExecutableDir() / "cache";
+
+    // Initialize default shader compiler, with compiled SPIR-V cached across runs
+#if defined(VROOM_WITH_SHADERC)
+    auto compiler = std::make_unique<ShadercShaderCompiler>();
+#else
+    auto compiler = std::make_unique<SystemShaderCompiler>();
+#endif
+    m_assetManager->setShaderCompiler(std::make_unique<CachingShaderCompiler>(std::move(compiler), cacheDir / "shaders"));
 
     // Register ShaderAsset loader
-    m_assetManager->registerLoader<ShaderAsset>([this](const std::vector<char>& data, const std::string& path) -> std::shared_ptr<ShaderAsset> {
-        std::string ext = std::filesystem::path(path).extension().string();
-        ShaderStage stage = ShaderStage::Unknown;
-
-        if (ext == ".vert" || ext == ".vs") stage = ShaderStage::Vertex;
-        else if (ext == ".frag" || ext == ".fs") stage = ShaderStage::Fragment;
-        else if (ext == ".comp") stage = ShaderStage::Compute;
-        else if (ext == ".geom") stage = ShaderStage::Geometry;
-        else if (ext == ".tesc") stage = ShaderStage::TessellationControl;
-        else if (ext == ".tese") stage = ShaderStage::TessellationEvaluation;
-        
+    // Uses the zero-copy loader so precompiled SPIR-V is referenced straight out of the package mapping
+    m_assetManager->registerLoader<ShaderAsset>([this](const AssetView& data, const std::string& path) -> std::shared_ptr<ShaderAsset> {
+        ShaderStage stage = shaderStageFromPath(path);
+
         // Check if it's already a SPIR-V binary
-        if (ext == ".spv") {
-            // Can't easily determine stage from just binary without parsing SPIR-V or relying on naming convention
-            // For now, assume naming convention shader.vert.spv
-             std::string stem = std::filesystem::path(path).stem().extension().string();
-             if (stem == ".vert") stage = ShaderStage::Vertex;
-             else if (stem == ".frag") stage = ShaderStage::Fragment;
-             
-             return std::make_shared<ShaderAsset>(data, stage);
+        if (std::filesystem::path(path).extension() == ".spv") {
+            return std::make_shared<ShaderAsset>(data, stage);
         }
 
         // It's source code, compile it
@@ -108,7 +108,7 @@ Engine::Engine(const EngineConfig& config)
     if (!m_config.headless) {
         initWindow();
 
-        m_renderer = std::make_unique<VulkanRenderer>(*m_assetManager);
+        m_renderer = std::make_unique<VulkanRenderer>(*m_assetManager, cacheDir / "pipeline_cache.bin");
         try {
             m_renderer->init(m_window);
         } catch (const std::exception& e) {
@@ -120,6 +120,7 @@ Engine::Engine(const EngineConfig& config)
     }
 
     m_sceneManager = std::make_shared<SceneManager>();
+    m_sceneManager->setJobSystem(m_jobSystem.get());
 }
 
 Engine::~Engine() {
@@ -138,6 +139,7 @@ Engine::~Engine() {
 
     m_sceneManager.reset();
     m_assetManager.reset();
+    m_jobSystem.reset();
     LOG_ENGINE_INFO("Engine shutdown complete, goodbye!");
 }
 
@@ -6,8 +6,8 @@
 
 namespace vroom {
 
-Entity::Entity(EntityId id, std::shared_ptr<Scene> scene)
-    : m_id(id), m_scene(std::move(scene)) {
+Entity::Entity(EntityId id, std::shared_ptr<Scene> scene, ComponentStorage* storage)
+    : m_id(id), m_scene(scene), m_linkScene(scene.get()), m_storage(storage) {
 }
 
 Entity::~Entity() {
@@ -16,16 +16,16 @@ Entity::~Entity() {
     // Detach children first
     // We create a copy because setParent(nullptr) modifies the m_children vector
     auto childrenCopy = m_children;
-    for (auto* child : childrenCopy) {
-        if (child) {
+    for (EntityHandle handle : childrenCopy) {
+        if (Entity* child = resolveLink(handle)) {
             child->setParent(nullptr);
         }
     }
 
     // Detach from parent
-    if (m_parent) {
-        auto& parentChildren = m_parent->m_children;
-        auto it = std::find(parentChildren.begin(), parentChildren.end(), this);
+    if (Entity* parent = getParent()) {
+        auto& parentChildren = parent->m_children;
+        auto it = std::find(parentChildren.begin(), parentChildren.end(), getHandle());
         if (it != parentChildren.end()) {
             parentChildren.erase(it);
         }
@@ -34,34 +34,161 @@ Entity::~Entity() {
     for (auto& component : m_components) {
         component->onDestroy();
     }
+    m_updatableComponents.clear();
     m_components.clear();
+    m_componentTypes.clear();
 }
 
-bool Entity::isActive() const {
-    return m_active && (!m_parent || m_parent->isActive());
+void Entity::registerComponent(ComponentTypeId type, ComponentPtr component, bool updatable) {
+    auto index = static_cast<uint32_t>(m_components.size());
+    Component* added = component.get();
+    m_components.push_back(std::move(component));
+    m_componentTypes.push_back(type);
+    // Listed for updates once started
+    if (updatable) {
+        added->markUpdatable();
+    }
+
+    // Lookups return the first component of a type, so later duplicates are not indexed
+    bool firstOfType = false;
+    if (ComponentMask::covers(type)) {
+        if (!m_componentMask.test(type)) {
+            m_maskedIndex.insert(m_maskedIndex.begin() + m_componentMask.countBelow(type), index);
+            m_componentMask.set(type);
+            firstOfType = true;
+        }
+    } else {
+        auto it = std::lower_bound(m_overflowIndex.begin(), m_overflowIndex.end(), type,
+            [](const auto& entry, ComponentTypeId id) { return entry.first < id; });
+        if (it == m_overflowIndex.end() || it->first != type) {
+            m_overflowIndex.insert(it, {type, index});
+            firstOfType = true;
+        }
+    }
+
+    if (auto scene = m_scene.lock()) {
+        // Components that cannot start yet are queued once they are enabled or activated
+        if (added->isEnabled() && isActive()) {
+            scene->queueStart(*this, *added);
+        }
+        if (firstOfType) {
+            scene->onComponentAdded(*this, type);
+        }
+    }
 }
 
-void Entity::update(float deltaTime) {
-    if (!isActive()) {
+bool Entity::removeComponent(ComponentTypeId type) {
+    auto it = std::find(m_componentTypes.begin(), m_componentTypes.end(), type);
+    if (it == m_componentTypes.end()) {
+        return false;
+    }
+    auto index = static_cast<size_t>(it - m_componentTypes.begin());
+
+    ComponentPtr component = std::move(m_components[index]);
+    m_components.erase(m_components.begin() + index);
+    m_componentTypes.erase(it);
+    removeUpdatable(component.get());
+
+    // Later components moved down one place
+    for (uint32_t& entry : m_maskedIndex) {
+        if (entry > index) {
+            --entry;
+        }
+    }
+    for (auto& entry : m_overflowIndex) {
+        if (entry.second > index) {
+            --entry.second;
+        }
+    }
+    reindexComponentType(type);
+
+    if (auto scene = m_scene.lock()) {
+        scene->onComponentRemoved(*this, type, *component);
+    }
+
+    if (component->isEnabled() && isActive()) {
+        component->onDisable();
+    }
+    component->onDestroy();
+    return true;
+}
+
+void Entity::reindexComponentType(ComponentTypeId type) {
+    // A later component of the same type, if any, takes over as the first one
+    auto it = std::find(m_componentTypes.begin(), m_componentTypes.end(), type);
+    bool found = it != m_componentTypes.end();
+    auto index = static_cast<uint32_t>(it - m_componentTypes.begin());
+
+    if (ComponentMask::covers(type)) {
+        size_t slot = m_componentMask.countBelow(type);
+        if (found) {
+            m_maskedIndex[slot] = index;
+        } else {
+            m_maskedIndex.erase(m_maskedIndex.begin() + slot);
+            m_componentMask.reset(type);
+        }
         return;
     }
 
-    for (auto& component : m_components) {
-        if (component->isEnabled()) {
-            if (!component->hasStarted()) {
-                component->start();
-                component->markStarted();
-            }
-            
-            // Check enabled again in case start() disabled the component
-            if (component->isEnabled()) {
-                component->update(deltaTime);
+    auto overflow = std::lower_bound(m_overflowIndex.begin(), m_overflowIndex.end(), type,
+        [](const auto& entry, ComponentTypeId id) { return entry.first < id; });
+    if (found) {
+        overflow->second = index;
+    } else {
+        m_overflowIndex.erase(overflow);
+    }
+}
+
+void Entity::updateComponents(float deltaTime) {
+    // Indexed, as components may be enabled while they update; those are first updated on the next frame
+    m_updatingComponents = true;
+    size_t componentCount = m_updatableComponents.size();
+    for (size_t i = 0; i < componentCount; ++i) {
+        if (Component* component = m_updatableComponents[i]) {
+            component->update(deltaTime);
+        }
+    }
+    m_updatingComponents = false;
+
+    if (m_hasDroppedUpdatables) {
+        std::erase(m_updatableComponents, nullptr);
+        m_hasDroppedUpdatables = false;
+    }
+}
+
+void Entity::onComponentStateChanged(Component& component) {
+    if (!component.hasStarted()) {
+        // Components that could not start when added are queued as soon as they can
+        if (component.isEnabled() && isActive()) {
+            if (auto scene = m_scene.lock()) {
+                scene->queueStart(*this, component);
             }
         }
+        return;
     }
 
-    for (auto* child : m_children) {
-        child->update(deltaTime);
+    if (!component.isUpdatable()) {
+        return;
+    }
+    bool listed = std::find(m_updatableComponents.begin(), m_updatableComponents.end(), &component) != m_updatableComponents.end();
+    if (component.isEnabled() && !listed) {
+        m_updatableComponents.push_back(&component);
+    } else if (!component.isEnabled() && listed) {
+        removeUpdatable(&component);
+    }
+}
+
+void Entity::removeUpdatable(Component* component) {
+    auto it = std::find(m_updatableComponents.begin(), m_updatableComponents.end(), component);
+    if (it == m_updatableComponents.end()) {
+        return;
+    }
+    // Erasing would shift the entries updateComponents() is walking
+    if (m_updatingComponents) {
+        *it = nullptr;
+        m_hasDroppedUpdatables = true;
+    } else {
+        m_updatableComponents.erase(it);
     }
 }
 
@@ -72,18 +199,35 @@ void Entity::setActive(bool active) {
 
     bool wasActive = isActive();
     m_active = active;
-    bool isNowActive = isActive();
+    Entity* parent = getParent();
+    bool isNowActive = m_active && (!parent || parent->isActive());
 
     if (wasActive != isNowActive) {
+        propagateActiveInHierarchy(isNowActive);
         handleActiveStateChange(wasActive, isNowActive);
     }
 }
 
+void Entity::propagateActiveInHierarchy(bool active) {
+    m_activeInHierarchy = active;
+    for (EntityHandle handle : m_children) {
+        Entity* child = resolveLink(handle);
+        // Inactive children stay inactive whatever their parent does
+        if (child && child->m_active) {
+            child->propagateActiveInHierarchy(active);
+        }
+    }
+}
+
 void Entity::handleActiveStateChange(bool wasActive, bool isNowActive) {
-    // Notify components
+    // Notify components; those that could not start while inactive are queued now
+    std::shared_ptr<Scene> scene = isNowActive ? m_scene.lock() : nullptr;
     for (auto& component : m_components) {
         if (component->isEnabled()) {
             if (isNowActive) {
+                if (scene && !component->hasStarted()) {
+                    scene->queueStart(*this, *component);
+                }
                 component->onEnable();
             } else {
                 component->onDisable();
@@ -92,17 +236,25 @@ void Entity::handleActiveStateChange(bool wasActive, bool isNowActive) {
     }
 
     // Notify children
-    for (auto* child : m_children) {
+    for (EntityHandle handle : m_children) {
+        Entity* child = resolveLink(handle);
         // Child's local active state hasn't changed, but effective state might have
         // If child.m_active is true, then its effective state follows parent
-        if (child->m_active) {
+        if (child && child->m_active) {
             child->handleActiveStateChange(wasActive, isNowActive);
         }
     }
 }
 
 void Entity::setParent(Entity* parent) {
-    if (m_parent == parent) {
+    Entity* oldParent = getParent();
+    if (oldParent == parent) {
+        return;
+    }
+
+    // Links are handles into the scene, so both ends must be entities of it
+    if (parent && (!m_linkScene || parent->m_linkScene != m_linkScene || resolveLink(parent->getHandle()) != parent)) {
+        LOG_ENGINE_CLASS_WARNING("Attempted to set a parent outside the entity's scene (Entity ID: " + std::to_string(m_id) + ")");
         return;
     }
 
@@ -118,22 +270,27 @@ void Entity::setParent(Entity* parent) {
 
     bool wasActive = isActive();
 
-    if (m_parent) {
-        auto& parentChildren = m_parent->m_children;
-        auto it = std::find(parentChildren.begin(), parentChildren.end(), this);
+    if (oldParent) {
+        auto& parentChildren = oldParent->m_children;
+        auto it = std::find(parentChildren.begin(), parentChildren.end(), getHandle());
         if (it != parentChildren.end()) {
             parentChildren.erase(it);
         }
     }
 
-    m_parent = parent;
+    m_parent = parent ? parent->getHandle() : EntityHandle{};
 
-    if (m_parent) {
-        m_parent->m_children.push_back(this);
+    if (parent) {
+        parent->m_children.push_back(getHandle());
     }
 
-    bool isNowActive = isActive();
+    if (auto scene = m_scene.lock()) {
+        scene->onParentChanged(*this, oldParent);
+    }
+
+    bool isNowActive = m_active && (!parent || parent->isActive());
     if (wasActive != isNowActive) {
+        propagateActiveInHierarchy(isNowActive);
         handleActiveStateChange(wasActive, isNowActive);
     }
 }
@@ -150,6 +307,18 @@ void Entity::removeChild(Entity* child) {
     }
 }
 
+Entity* Entity::getParent() const {
+    return m_parent.isNull() ? nullptr : resolveLink(m_parent);
+}
+
+Entity* Entity::getChild(size_t index) const {
+    return resolveLink(m_children[index]);
+}
+
+Entity* Entity::resolveLink(EntityHandle handle) const {
+    return m_linkScene ? m_linkScene->getLinkedEntity(handle) : nullptr;
+}
+
 SceneManager* Entity::getSceneManager() const {
     if (auto scene = m_scene.lock()) {
         return scene->getSceneManager();
@@ -0,0 +1,80 @@
+#include "vroom/core/EntityCommandBuffer.hpp"
+#include "vroom/core/Scene.hpp"
+
+namespace vroom {
+
+// Placeholders use generation 0, which no live slot has, and count creations in the index
+EntityHandle EntityCommandBuffer::createEntity() {
+    EntityHandle placeholder{m_createdCount++, 0};
+    record(CommandType::CreateEntity, placeholder);
+    return placeholder;
+}
+
+void EntityCommandBuffer::destroyEntity(EntityHandle entity) {
+    record(CommandType::DestroyEntity, entity);
+}
+
+void EntityCommandBuffer::setParent(EntityHandle entity, EntityHandle parent) {
+    record(CommandType::SetParent, entity).parent = parent;
+}
+
+EntityCommandBuffer::Command& EntityCommandBuffer::record(CommandType type, EntityHandle entity) {
+    Command& command = m_commands.emplace_back();
+    command.type = type;
+    command.entity = entity;
+    return command;
+}
+
+Entity* EntityCommandBuffer::resolve(Scene& scene, EntityHandle handle, const std::vector<EntityHandle>& created) const {
+    if (!handle.isNull() && handle.generation == 0) {
+        return handle.index < created.size() ? scene.getEntity(created[handle.index]) : nullptr;
+    }
+    return scene.getEntity(handle);
+}
+
+void EntityCommandBuffer::playback(Scene& scene) {
+    // Taken up front, so commands recorded while playing back (from awake(), say) are kept
+    auto commands = std::exchange(m_commands, {});
+    m_createdCount = 0;
+
+    std::vector<EntityHandle> created; // Scene handle of each placeholder
+    for (Command& command : commands) {
+        if (command.type == CommandType::CreateEntity) {
+            created.push_back(scene.createEntity().getHandle());
+            continue;
+        }
+
+        Entity* entity = resolve(scene, command.entity, created);
+        if (!entity) {
+            continue;
+        }
+
+        switch (command.type) {
+        case CommandType::DestroyEntity:
+            scene.destroyEntity(*entity);
+            break;
+        case CommandType::AddComponent:
+            command.addComponent(*entity);
+            break;
+        case CommandType::RemoveComponent:
+            entity->removeComponent(command.componentType);
+            break;
+        case CommandType::SetParent:
+            if (command.parent.isNull()) {
+                entity->setParent(nullptr);
+            } else if (Entity* parent = resolve(scene, command.parent, created)) {
+                entity->setParent(parent);
+            }
+            break;
+        case CommandType::CreateEntity:
+            break;
+        }
+    }
+}
+
+void EntityCommandBuffer::clear() {
+    m_commands.clear();
+    m_createdCount = 0;
+}
+
+} // namespace vroom
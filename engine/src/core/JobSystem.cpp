@@ -0,0 +1,203 @@
+#include "vroom/core/JobSystem.hpp"
+#include "vroom/logging/LogMacros.hpp"
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace vroom {
+
+namespace {
+
+constexpr size_t NotAWorker = std::numeric_limits<size_t>::max();
+
+// Identifies the job system and worker slot the current thread belongs to
+thread_local const JobSystem* t_owner = nullptr;
+thread_local size_t t_workerIndex = NotAWorker;
+
+} // namespace
+
+JobSystem::JobSystem(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Every deque exists before any worker starts looking for jobs to steal
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool JobSystem::isWorkerThread() const {
+    return t_owner == this;
+}
+
+void JobSystem::run(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Counted before it is visible, so takers never see more jobs than the count
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+    if (isWorkerThread()) {
+        Worker& worker = *m_workers[t_workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back({std::move(job), counter});
+    } else {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        m_sharedJobs.push_back({std::move(job), counter});
+    }
+
+    // Taking the lock orders this wake-up after a sleeping worker's last check
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wakeCondition.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    size_t index = isWorkerThread() ? t_workerIndex : NotAWorker;
+    QueuedJob job;
+    while (!counter.isDone()) {
+        if (takeJob(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        // Nothing to help with; sleep briefly in case new jobs show up before the counter drains
+        std::unique_lock<std::mutex> lock(counter.m_mutex);
+        counter.m_finished.wait_for(lock, std::chrono::microseconds(200), [&counter]() { return counter.isDone(); });
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        error = std::exchange(counter.m_error, nullptr);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool JobSystem::takeJob(size_t index, QueuedJob& out) {
+    if (m_queuedJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // Own deque first, newest job first
+    if (index != NotAWorker) {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            out = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        if (!m_sharedJobs.empty()) {
+            out = std::move(m_sharedJobs.front());
+            m_sharedJobs.pop_front();
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another worker, starting with the next one along
+    size_t start = index == NotAWorker ? 0 : index + 1;
+    for (size_t offset = 0; offset < m_workers.size(); ++offset) {
+        size_t victim = (start + offset) % m_workers.size();
+        if (victim == index) {
+            continue;
+        }
+
+        Worker& worker = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            out = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(QueuedJob& job) {
+    std::exception_ptr error;
+    try {
+        job.job();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // Release whatever the job captured before it counts as finished
+    job.job = nullptr;
+
+    JobCounter* counter = job.counter;
+    if (!counter) {
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                LOG_ENGINE_CLASS_ERROR("Unhandled exception in job: " + std::string(e.what()));
+            } catch (...) {
+                LOG_ENGINE_CLASS_ERROR("Unhandled exception in job");
+            }
+        }
+        return;
+    }
+
+    // Decremented under the lock so a waiter cannot see the counter drain and destroy it
+    // while this thread still uses it
+    std::lock_guard<std::mutex> lock(counter->m_mutex);
+    if (error && !counter->m_error) {
+        counter->m_error = error;
+    }
+    if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        counter->m_finished.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(size_t index) {
+    t_owner = this;
+    t_workerIndex = index;
+
+    QueuedJob job;
+    while (true) {
+        if (takeJob(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this]() {
+            return m_stopping || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        // Queued jobs are drained before exiting
+        if (m_stopping && m_queuedJobs.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace vroom
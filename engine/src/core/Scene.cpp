@@ -1,6 +1,9 @@
 #include "vroom/core/Scene.hpp"
+#include "vroom/core/SceneManager.hpp"
 #include "vroom/logging/LogMacros.hpp"
 
+#include <utility>
+
 namespace vroom {
 
 Scene::Scene() {
@@ -13,72 +16,246 @@ Scene::~Scene() {
 }
 
 Entity& Scene::createEntity() {
-    auto entity = std::make_shared<Entity>(generateEntityId(), shared_from_this());
-    m_entities.push_back(entity);
-    LOG_ENGINE_CLASS_DEBUG("Created Entity ID: " + std::to_string(entity->getId()));
-    return *entity;
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    EntitySlot& slot = m_slots[index];
+    EntityHandle handle{index, slot.generation};
+    Entity& entity = slot.entity.emplace(handle.toId(), shared_from_this(), &m_componentStorage);
+    // New roots go at the end of the hierarchy, past the range update() is walking
+    m_hierarchy.add(entity);
+    ++m_entityCount;
+    LOG_ENGINE_CLASS_DEBUG("Created Entity ID: " + std::to_string(entity.getId()));
+    return entity;
 }
 
 void Scene::destroyEntity(Entity& entity) {
-    // First, handle children recursively
-    // We make a copy of the children list because it will be modified as we destroy them
-    std::vector<Entity*> children = entity.getChildren();
-    for (auto* child : children) {
-        if (child) {
-            destroyEntity(*child);
+    EntityHandle handle = entity.getHandle();
+    // Entities of other scenes (or none) are not ours to destroy
+    if (getEntity(handle) != &entity) {
+        return;
+    }
+    destroyEntity(handle);
+}
+
+void Scene::destroyEntity(EntityHandle handle) {
+    Entity* root = getEntity(handle);
+    if (!root) {
+        return;
+    }
+
+    // Mark the whole subtree; nothing is freed until the flush, so entities in the middle
+    // of their update stay valid
+    std::vector<Entity*> stack{root};
+    while (!stack.empty()) {
+        Entity* entity = stack.back();
+        stack.pop_back();
+        entity->markDestroyed();
+        m_destroyedSlots.push_back(entity->getHandle().index);
+        --m_entityCount;
+
+        for (size_t i = 0; i < entity->getChildren().size(); ++i) {
+            Entity* child = entity->getChild(i);
+            if (child && !child->isDestroyed()) {
+                stack.push_back(child);
+            }
         }
     }
+}
 
-    // Remove from parent if exists
-    if (auto* parent = entity.getParent()) {
-        parent->removeChild(&entity);
+void Scene::flushDestroyedEntities() {
+    if (m_destroyedSlots.empty()) {
+        return;
     }
 
-    // Remove from scene storage
-    auto it = std::remove_if(m_entities.begin(), m_entities.end(), 
-        [&entity](const std::shared_ptr<Entity>& e) {
-            return e.get() == &entity;
-        });
-    
-    if (it != m_entities.end()) {
-        m_entities.erase(it, m_entities.end());
+    // One compaction pass per query while the destroyed entities are still readable
+    for (auto& cache : m_queries) {
+        if (cache) {
+            cache->removeDestroyed();
+        }
+    }
+    std::vector<uint32_t> destroyed;
+    destroyed.reserve(m_destroyedSlots.size());
+    m_hierarchy.removeDestroyed(destroyed);
+    m_destroyedSlots.clear();
+
+    // Reverse pre-order frees descendants before their ancestors, whichever destroyEntity()
+    // calls marked them, so no entity is reparented (or re-enabled) while its subtree is torn down
+    for (auto it = destroyed.rbegin(); it != destroyed.rend(); ++it) {
+        destroySlot(*it);
+    }
+}
+
+void Scene::destroySlot(uint32_t index) {
+    EntitySlot& slot = m_slots[index];
+    // Detaches from a surviving parent, if any
+    slot.entity.reset();
+    // Generation 0 is never live, so null-initialized handles cannot match a slot
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    m_freeSlots.push_back(index);
+}
+
+void Scene::submitCommands(EntityCommandBuffer&& commands) {
+    if (commands.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_submittedCommands.push_back(std::move(commands));
+}
+
+void Scene::playbackCommands() {
+    std::vector<EntityCommandBuffer> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        buffers.swap(m_submittedCommands);
+    }
+
+    // Stable, so buffers sharing a key keep their submission order
+    std::stable_sort(buffers.begin(), buffers.end(), [](const auto& a, const auto& b) {
+        return a.getSortKey() < b.getSortKey();
+    });
+    for (auto& buffer : buffers) {
+        buffer.playback(*this);
     }
 }
 
 void Scene::update(float deltaTime) {
-    // Iterate using index to allow safe addition of entities during update (though removal might be tricky)
-    // Ideally we'd have a "pending addition" and "pending removal" list, but for now direct iteration
-    // We copy the vector to avoid iterator invalidation if entities are added/removed
-    auto entitiesSnapshot = m_entities;
-    
-    for (const auto& entity : entitiesSnapshot) {
-        // Only update root entities to avoid double updates, as Entity::update handles children recursively
-        if (entity && entity->isActive() && entity->getParent() == nullptr) {
-             entity->update(deltaTime);
+    startComponents();
+
+    // One linear pass in parent-before-child order. Entities created during the update land
+    // past entityCount and wait for the next frame, destroyed ones stay put until the flush
+    // below, and reparenting only reorders the hierarchy once the pass is over.
+    m_updating = true;
+    size_t entityCount = m_hierarchy.size();
+    for (size_t position = 0; position < entityCount; ++position) {
+        Entity& entity = m_hierarchy.getEntity(position);
+        if (entity.isActive() && !entity.isDestroyed()) {
+            entity.updateComponents(deltaTime);
         }
     }
+    m_updating = false;
+    if (m_hierarchyDirty) {
+        m_hierarchy.rebuild();
+        m_hierarchyDirty = false;
+    }
+
+    if (m_systems.size() > 0) {
+        // A lone system gains nothing from a worker hop
+        JobSystem* jobs = m_systems.size() > 1 && m_sceneManager ? &m_sceneManager->getJobSystem() : nullptr;
+        m_systems.run(*this, deltaTime, jobs);
+    }
+
+    playbackCommands();
+    flushDestroyedEntities();
+    updateTransforms();
 }
 
 void Scene::clear() {
-    if (!m_entities.empty()) {
-        LOG_ENGINE_CLASS_INFO("Clearing scene, destroying " + std::to_string(m_entities.size()) + " entities");
-        m_entities.clear();
+    if (m_entityCount > 0) {
+        LOG_ENGINE_CLASS_INFO("Clearing scene, destroying " + std::to_string(m_entityCount) + " entities");
+    }
+    for (auto& cache : m_queries) {
+        if (cache) {
+            cache->clear();
+        }
     }
-    m_nextEntityId = 1;
+    // Cleared first, so entities detaching from parents on the way out are not tracked
+    m_hierarchy.clear();
+    m_hierarchyDirty = false;
+    m_pendingStarts.clear();
+    for (uint32_t index = 0; index < m_slots.size(); ++index) {
+        if (m_slots[index].entity) {
+            destroySlot(index);
+        }
+    }
+    m_destroyedSlots.clear();
+    m_entityCount = 0;
+
+    // Commands recorded against the old entities have nothing left to apply to
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_submittedCommands.clear();
 }
 
 std::vector<Entity*> Scene::getRootEntities() const {
     std::vector<Entity*> roots;
-    for (const auto& entity : m_entities) {
-        if (entity->getParent() == nullptr) {
-            roots.push_back(entity.get());
+    for (size_t position = 0; position < m_hierarchy.size(); position += m_hierarchy.getSubtreeSize(position)) {
+        Entity& entity = m_hierarchy.getEntity(position);
+        // Destroyed roots take their subtree with them
+        if (!entity.isDestroyed()) {
+            roots.push_back(&entity);
         }
     }
     return roots;
 }
 
-EntityId Scene::generateEntityId() {
-    return m_nextEntityId++;
+void Scene::onComponentAdded(Entity& entity, ComponentTypeId type) {
+    for (auto& cache : m_queries) {
+        // The entity cannot have matched before, as it lacked this type
+        if (cache && cache->involves(type)) {
+            cache->tryAdd(entity);
+        }
+    }
+}
+
+void Scene::onComponentRemoved(Entity& entity, ComponentTypeId type, Component& component) {
+    for (auto& pending : m_pendingStarts) {
+        if (pending.component == &component) {
+            pending.component = nullptr;
+        }
+    }
+
+    for (auto& cache : m_queries) {
+        if (cache && cache->involves(type)) {
+            // Re-added if another component of the type takes over
+            cache->remove(entity);
+            cache->tryAdd(entity);
+        }
+    }
+}
+
+void Scene::queueStart(Entity& entity, Component& component) {
+    m_pendingStarts.push_back({entity.getHandle(), &component});
+}
+
+void Scene::startComponents() {
+    // Indexed, as start() may queue more components; those are started in this pass too.
+    // Components disabled or deactivated since they were queued are dropped, and queued
+    // again by their entity once they are enabled and active.
+    for (size_t i = 0; i < m_pendingStarts.size(); ++i) {
+        PendingStart pending = m_pendingStarts[i];
+        Entity* entity = getEntity(pending.entity);
+        if (!entity || !pending.component || pending.component->hasStarted() ||
+            !pending.component->isEnabled() || !entity->isActive()) {
+            continue;
+        }
+        pending.component->start();
+        pending.component->markStarted();
+    }
+    m_pendingStarts.clear();
+}
+
+void Scene::onParentChanged(Entity& entity, Entity* oldParent) {
+    m_transforms.markDirty(entity.getHandle());
+    // Moving subtrees would shift entities under the update loop
+    if (m_updating) {
+        m_hierarchyDirty = true;
+        return;
+    }
+    m_hierarchy.reparent(entity, oldParent);
+}
+
+std::unique_ptr<QueryCache> Scene::buildQuery(std::vector<ComponentTypeId> types) {
+    auto cache = std::make_unique<QueryCache>(std::move(types));
+    forEachEntity([&cache](Entity& entity) { cache->tryAdd(entity); });
+    return cache;
 }
 
 } // namespace vroom
@@ -0,0 +1,188 @@
+#include "vroom/core/SceneHierarchy.hpp"
+#include "vroom/core/Entity.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vroom {
+
+uint32_t SceneHierarchy::find(const Entity& entity) const {
+    uint32_t slot = entity.getHandle().index;
+    if (slot >= m_positions.size()) {
+        return NoPosition;
+    }
+    // Entities of another scene may share the slot index
+    uint32_t position = m_positions[slot];
+    return position < m_entities.size() && m_entities[position] == &entity ? position : NoPosition;
+}
+
+void SceneHierarchy::add(Entity& entity) {
+    uint32_t slot = entity.getHandle().index;
+    if (slot >= m_positions.size()) {
+        m_positions.resize(slot + 1, NoPosition);
+    }
+    m_positions[slot] = static_cast<uint32_t>(m_entities.size());
+    m_entities.push_back(&entity);
+    m_slots.push_back(slot);
+    m_parents.push_back(NoPosition);
+    m_subtreeSizes.push_back(1);
+}
+
+void SceneHierarchy::reparent(Entity& entity, Entity* oldParent) {
+    uint32_t position = find(entity);
+    if (position == NoPosition) {
+        return;
+    }
+    uint32_t count = m_subtreeSizes[position];
+
+    // The subtree goes right after the last descendant of its new parent. A parent outside
+    // this hierarchy is treated like none.
+    Entity* newParent = entity.getParent();
+    uint32_t parentPosition = newParent ? find(*newParent) : NoPosition;
+    size_t target = parentPosition == NoPosition ? m_entities.size() : parentPosition + m_subtreeSizes[parentPosition];
+
+    // Rotate the subtree into place; only the range between its old and new place moves
+    size_t first, last;
+    if (target >= position + count) {
+        first = position;
+        last = target;
+        auto rotateLeft = [&](auto& values) {
+            std::rotate(values.begin() + first, values.begin() + position + count, values.begin() + last);
+        };
+        rotateLeft(m_entities);
+        rotateLeft(m_slots);
+        rotateLeft(m_parents);
+        rotateLeft(m_subtreeSizes);
+    } else {
+        first = target;
+        last = position + count;
+        auto rotateRight = [&](auto& values) {
+            std::rotate(values.begin() + first, values.begin() + position, values.begin() + last);
+        };
+        rotateRight(m_entities);
+        rotateRight(m_slots);
+        rotateRight(m_parents);
+        rotateRight(m_subtreeSizes);
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        m_positions[m_slots[i]] = static_cast<uint32_t>(i);
+    }
+    // Every parent link into or out of the moved range points at a new position
+    for (size_t i = first; i < last; ++i) {
+        const Entity& entity = *m_entities[i];
+        Entity* parent = entity.getParent();
+        m_parents[i] = parent ? find(*parent) : NoPosition;
+        for (size_t index = 0; index < entity.getChildren().size(); ++index) {
+            Entity* child = entity.getChild(index);
+            uint32_t childPosition = child ? find(*child) : NoPosition;
+            if (childPosition != NoPosition) {
+                m_parents[childPosition] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    for (Entity* ancestor = oldParent; ancestor; ancestor = ancestor->getParent()) {
+        uint32_t ancestorPosition = find(*ancestor);
+        if (ancestorPosition != NoPosition) {
+            m_subtreeSizes[ancestorPosition] -= count;
+        }
+    }
+    for (Entity* ancestor = newParent; ancestor; ancestor = ancestor->getParent()) {
+        uint32_t ancestorPosition = find(*ancestor);
+        if (ancestorPosition != NoPosition) {
+            m_subtreeSizes[ancestorPosition] += count;
+        }
+    }
+}
+
+void SceneHierarchy::removeDestroyed(std::vector<uint32_t>& removedSlots) {
+    // Destroyed entities take their whole subtree with them, so the survivors stay in pre-order
+    size_t kept = 0;
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        Entity* entity = m_entities[i];
+        uint32_t slot = m_slots[i];
+        if (entity->isDestroyed()) {
+            m_positions[slot] = NoPosition;
+            removedSlots.push_back(slot);
+            continue;
+        }
+        m_entities[kept] = entity;
+        m_slots[kept] = slot;
+        m_positions[slot] = static_cast<uint32_t>(kept);
+        ++kept;
+    }
+    if (kept == m_entities.size()) {
+        return;
+    }
+    m_entities.resize(kept);
+    m_slots.resize(kept);
+    recomputeLinks();
+}
+
+void SceneHierarchy::rebuild() {
+    auto previous = std::exchange(m_entities, {});
+    // m_positions still describes the previous order until the end
+    auto contains = [&](const Entity& entity) {
+        uint32_t slot = entity.getHandle().index;
+        return slot < m_positions.size() && m_positions[slot] < previous.size() && previous[m_positions[slot]] == &entity;
+    };
+
+    m_entities.reserve(previous.size());
+    for (Entity* entity : previous) {
+        // As in reparent(), a parent outside this hierarchy is treated like none
+        Entity* parent = entity->getParent();
+        if (!parent || !contains(*parent)) {
+            appendSubtree(*entity, contains);
+        }
+    }
+    m_slots.resize(m_entities.size());
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+        m_slots[i] = m_entities[i]->getHandle().index;
+        m_positions[m_slots[i]] = static_cast<uint32_t>(i);
+    }
+    recomputeLinks();
+}
+
+void SceneHierarchy::clear() {
+    m_entities.clear();
+    m_slots.clear();
+    m_parents.clear();
+    m_subtreeSizes.clear();
+    m_positions.clear();
+}
+
+template <typename Contains>
+void SceneHierarchy::appendSubtree(Entity& root, const Contains& contains) {
+    std::vector<Entity*> stack{&root};
+    while (!stack.empty()) {
+        Entity* entity = stack.back();
+        stack.pop_back();
+        m_entities.push_back(entity);
+        // Reversed, so the first child comes out first
+        for (size_t i = entity->getChildren().size(); i-- > 0;) {
+            Entity* child = entity->getChild(i);
+            if (child && contains(*child)) {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void SceneHierarchy::recomputeLinks() {
+    size_t count = m_entities.size();
+    m_parents.resize(count);
+    m_subtreeSizes.assign(count, 1);
+    for (size_t i = 0; i < count; ++i) {
+        Entity* parent = m_entities[i]->getParent();
+        m_parents[i] = parent ? find(*parent) : NoPosition;
+    }
+    // Children come after their parent, so walking backwards completes each subtree first
+    for (size_t i = count; i-- > 0;) {
+        if (m_parents[i] != NoPosition) {
+            m_subtreeSizes[m_parents[i]] += m_subtreeSizes[i];
+        }
+    }
+}
+
+} // namespace vroom
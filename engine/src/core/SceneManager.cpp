@@ -1,4 +1,6 @@
 #include "vroom/core/SceneManager.hpp"
+#include "vroom/core/ComponentRegistry.hpp"
+#include "vroom/core/SceneSerializer.hpp"
 #include "vroom/logging/LogMacros.hpp"
 #include <algorithm>
 #include <iostream>
@@ -7,8 +9,9 @@
 
 namespace vroom {
 
-SceneManager::SceneManager() {
+SceneManager::SceneManager() : m_componentRegistry(std::make_unique<ComponentRegistry>()) {
     LOG_ENGINE_CLASS_INFO("Initializing SceneManager");
+    m_componentRegistry->registerBuiltins();
     // Initialize with a default empty scene
     m_activeScene = std::make_shared<Scene>();
     m_activeScene->setSceneManager(this);
@@ -17,6 +20,10 @@ SceneManager::SceneManager() {
 
 SceneManager::~SceneManager() {
     LOG_ENGINE_CLASS_INFO("Shutting down SceneManager");
+    // Async loads reference this manager, so let them finish first
+    if (m_jobSystem) {
+        m_jobSystem->wait(m_pendingLoads);
+    }
     std::lock_guard<std::mutex> lock(m_mutex);
     m_scenes.clear();
     m_activeScene.reset();
@@ -44,17 +51,16 @@ void SceneManager::loadScene(std::shared_ptr<Scene> scene) {
 
 std::future<void> SceneManager::loadSceneAsync(const std::string& path) {
     LOG_ENGINE_CLASS_INFO("Starting async scene load from path: " + path);
-    return std::async(std::launch::async, [self = shared_from_this(), path]() {
-        // Load the scene in the background thread
-        auto newScene = self->createSceneFromFile(path);
+    return runLoadJob([this, path]() {
+        // Load the scene on a worker
+        auto newScene = createSceneFromFile(path);
         
         // Lock only when swapping the scenes
-        std::lock_guard<std::mutex> lock(self->m_mutex);
-        self->m_scenes.clear();
-        self->m_scenes.push_back(newScene);
-        self->m_activeScene = newScene;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scenes.clear();
+        m_scenes.push_back(newScene);
+        m_activeScene = newScene;
         
-        // We use the static logger variant because we are in a lambda and 'this' is not captured/valid
         LOG_ENGINE_STATIC_INFO("SceneManager", "Async scene load complete: " + path);
     });
 }
@@ -73,18 +79,32 @@ void SceneManager::loadSceneAdditive(const std::string& path) {
 
 std::future<void> SceneManager::loadSceneAdditiveAsync(const std::string& path) {
     LOG_ENGINE_CLASS_INFO("Starting async additive scene load from path: " + path);
-    return std::async(std::launch::async, [self = shared_from_this(), path]() {
-        auto newScene = self->createSceneFromFile(path);
+    return runLoadJob([this, path]() {
+        auto newScene = createSceneFromFile(path);
         
-        std::lock_guard<std::mutex> lock(self->m_mutex);
-        self->m_scenes.push_back(newScene);
-        if (!self->m_activeScene) {
-            self->m_activeScene = newScene;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scenes.push_back(newScene);
+        if (!m_activeScene) {
+            m_activeScene = newScene;
         }
         LOG_ENGINE_STATIC_INFO("SceneManager", "Async additive scene load complete: " + path);
     });
 }
 
+std::future<void> SceneManager::runLoadJob(std::function<void()> load) {
+    auto promise = std::make_shared<std::promise<void>>();
+    auto future = promise->get_future();
+    getJobSystem().run([load = std::move(load), promise]() {
+        try {
+            load();
+            promise->set_value();
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    }, &m_pendingLoads);
+    return future;
+}
+
 void SceneManager::unloadScene(std::shared_ptr<Scene> scene) {
     std::lock_guard<std::mutex> lock(m_mutex);
     auto it = std::remove(m_scenes.begin(), m_scenes.end(), scene);
@@ -124,16 +144,32 @@ std::shared_ptr<Scene> SceneManager::getActiveScene() const {
     return m_activeScene;
 }
 
+void SceneManager::setJobSystem(JobSystem* jobs) {
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    m_jobSystem = jobs;
+}
+
+JobSystem& SceneManager::getJobSystem() {
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    if (!m_jobSystem) {
+        m_ownedJobSystem = std::make_unique<JobSystem>();
+        m_jobSystem = m_ownedJobSystem.get();
+    }
+    return *m_jobSystem;
+}
+
 std::shared_ptr<Scene> SceneManager::createSceneFromFile(const std::string& path) {
-    // TODO: Implement actual file loading/deserialization logic here.
-    // For now, we just return a new empty scene.
-    // We could populate it with some test entities based on 'path' for demonstration.
-    
     auto scene = std::make_shared<Scene>();
     scene->setSceneManager(this);
-    // Example: scene->createEntity();
+    // A scene that fails to load comes up empty rather than failing the load
+    if (!SceneSerializer(*m_componentRegistry).loadFile(*scene, path)) {
+        LOG_ENGINE_CLASS_ERROR("Failed to load scene: " + path);
+    }
     return scene;
 }
 
-} // namespace vroom
+bool SceneManager::saveScene(Scene& scene, const std::string& path) const {
+    return SceneSerializer(*m_componentRegistry).saveFile(scene, path);
+}
 
+} // namespace vroom
@@ -0,0 +1,87 @@
+#include "vroom/core/SceneQuery.hpp"
+#include "vroom/core/Entity.hpp"
+
+#include <atomic>
+
+namespace vroom {
+
+namespace detail {
+size_t nextQueryId() {
+    static std::atomic<size_t> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace detail
+
+QueryCache::QueryCache(std::vector<ComponentTypeId> types)
+    : m_types(std::move(types)) {
+}
+
+void QueryCache::tryAdd(Entity& entity) {
+    size_t first = m_components.size();
+    for (ComponentTypeId type : m_types) {
+        Component* component = entity.findComponent(type);
+        if (!component) {
+            m_components.resize(first);
+            return;
+        }
+        m_components.push_back(component);
+    }
+    m_entities.push_back(&entity);
+}
+
+void QueryCache::remove(Entity& entity) {
+    auto it = std::find(m_entities.begin(), m_entities.end(), &entity);
+    if (it == m_entities.end()) {
+        return;
+    }
+
+    // Swapping the last match in would move it behind a running iteration
+    if (m_iterations > 0) {
+        *it = nullptr;
+        m_hasRemovedWhileIterating = true;
+        return;
+    }
+
+    size_t width = m_types.size();
+    size_t match = it - m_entities.begin();
+    size_t last = m_entities.size() - 1;
+    if (match != last) {
+        m_entities[match] = m_entities[last];
+        std::copy_n(m_components.begin() + last * width, width, m_components.begin() + match * width);
+    }
+    m_entities.pop_back();
+    m_components.resize(last * width);
+}
+
+void QueryCache::endIteration() {
+    if (--m_iterations == 0 && m_hasRemovedWhileIterating) {
+        removeDestroyed();
+    }
+}
+
+void QueryCache::removeDestroyed() {
+    // Compact surviving matches towards the front, keeping their order. Entries nulled
+    // while iterating go too.
+    m_hasRemovedWhileIterating = false;
+    size_t width = m_types.size();
+    size_t kept = 0;
+    for (size_t match = 0; match < m_entities.size(); ++match) {
+        if (!m_entities[match] || m_entities[match]->isDestroyed()) {
+            continue;
+        }
+        if (kept != match) {
+            m_entities[kept] = m_entities[match];
+            std::copy_n(m_components.begin() + match * width, width, m_components.begin() + kept * width);
+        }
+        ++kept;
+    }
+    m_entities.resize(kept);
+    m_components.resize(kept * width);
+}
+
+void QueryCache::clear() {
+    m_entities.clear();
+    m_components.clear();
+}
+
+} // namespace vroom
@@ -0,0 +1,394 @@
+#include "vroom/core/SceneSerializer.hpp"
+#include "vroom/core/SceneFormat.hpp"
+#include "vroom/core/SceneHierarchy.hpp"
+#include "vroom/asset/MappedFile.hpp"
+#include "vroom/logging/LogMacros.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace vroom {
+
+namespace {
+
+// Components of one type to add, whichever form they were read from
+struct LoadedComponents {
+    const ComponentTypeInfo* type;
+    std::vector<uint32_t> entities; // Indices into the entity records
+    const char* data;               // entities.size() values of type->dataSize bytes
+    std::vector<char> ownedData;    // Backs data when it does not point into the input
+};
+
+// The scene's live entities in hierarchy order, and the index of each hierarchy position in it
+struct SavedEntities {
+    std::vector<SceneEntityRecord> records;
+    std::vector<uint32_t> indices; // By hierarchy position; SCENE_NO_PARENT for destroyed entities
+};
+
+SavedEntities collectEntities(const Scene& scene) {
+    const SceneHierarchy& hierarchy = scene.getHierarchy();
+    SavedEntities saved;
+    saved.records.reserve(hierarchy.size());
+    saved.indices.assign(hierarchy.size(), SCENE_NO_PARENT);
+    for (size_t position = 0; position < hierarchy.size(); ++position) {
+        const Entity& entity = hierarchy.getEntity(position);
+        if (entity.isDestroyed()) {
+            continue;
+        }
+        uint32_t parent = hierarchy.getParent(position);
+        saved.records.push_back({
+            parent == SceneHierarchy::NoPosition ? SCENE_NO_PARENT : saved.indices[parent],
+            entity.isActiveSelf() ? 0u : SCENE_ENTITY_INACTIVE,
+        });
+        saved.indices[position] = static_cast<uint32_t>(saved.records.size() - 1);
+    }
+    return saved;
+}
+
+// Saves the components of one type, with the index of each owner among the saved entities
+void collectComponents(Scene& scene, const ComponentTypeInfo& type, const SavedEntities& saved,
+                       std::vector<uint32_t>& owners, std::vector<char>& data) {
+    std::vector<Entity*> entities;
+    type.save(scene, entities, data);
+    const SceneHierarchy& hierarchy = scene.getHierarchy();
+    owners.resize(entities.size());
+    for (size_t i = 0; i < entities.size(); ++i) {
+        owners[i] = saved.indices[hierarchy.find(*entities[i])];
+    }
+}
+
+void appendBytes(std::vector<char>& out, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void padToAlignment(std::vector<char>& out, size_t base) {
+    out.resize(base + alignSceneOffset(out.size() - base), 0);
+}
+
+// Appends a chunk whose payload write() appends, then fills in its size
+template <typename Write>
+void appendChunk(std::vector<char>& out, const char (&tag)[4], uint32_t elementCount, uint32_t elementSize,
+                 uint32_t nameLength, Write&& write) {
+    SceneChunkHeader chunk;
+    std::memcpy(chunk.tag, tag, sizeof(chunk.tag));
+    chunk.elementCount = elementCount;
+    chunk.elementSize = elementSize;
+    chunk.nameLength = nameLength;
+
+    size_t headerOffset = out.size();
+    appendBytes(out, &chunk, sizeof(chunk));
+    size_t payloadOffset = out.size();
+    write(payloadOffset);
+    padToAlignment(out, payloadOffset);
+
+    chunk.size = out.size() - payloadOffset;
+    std::memcpy(out.data() + headerOffset, &chunk, sizeof(chunk));
+}
+
+void instantiate(Scene& scene, const std::vector<SceneEntityRecord>& records,
+                 const std::vector<LoadedComponents>& components) {
+    std::vector<Entity*> entities(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        Entity& entity = scene.createEntity();
+        if (records[i].parent != SCENE_NO_PARENT) {
+            entity.setParent(entities[records[i].parent]);
+        }
+        // Before any component is added, so components of inactive entities are never enabled
+        if (records[i].flags & SCENE_ENTITY_INACTIVE) {
+            entity.setActive(false);
+        }
+        entities[i] = &entity;
+    }
+
+    std::vector<Entity*> owners;
+    for (const LoadedComponents& loaded : components) {
+        owners.resize(loaded.entities.size());
+        for (size_t i = 0; i < owners.size(); ++i) {
+            owners[i] = entities[loaded.entities[i]];
+        }
+        loaded.type->load(owners.data(), loaded.data, owners.size());
+    }
+}
+
+bool hasJsonExtension(const std::filesystem::path& path) {
+    return path.extension() == ".json";
+}
+
+} // namespace
+
+std::vector<char> SceneSerializer::saveBinary(Scene& scene) const {
+    SavedEntities saved = collectEntities(scene);
+
+    std::vector<char> out;
+    SceneFileHeader header;
+    appendBytes(out, &header, sizeof(header));
+
+    const uint32_t entityCount = static_cast<uint32_t>(saved.records.size());
+    appendChunk(out, SCENE_ENTITY_CHUNK, entityCount, sizeof(SceneEntityRecord), 0, [&](size_t) {
+        appendBytes(out, saved.records.data(), saved.records.size() * sizeof(SceneEntityRecord));
+    });
+    ++header.chunkCount;
+
+    std::vector<uint32_t> owners;
+    std::vector<char> data;
+    for (const ComponentTypeInfo& type : m_registry.getTypes()) {
+        owners.clear();
+        data.clear();
+        collectComponents(scene, type, saved, owners, data);
+        if (owners.empty()) {
+            continue;
+        }
+
+        const uint32_t nameLength = static_cast<uint32_t>(type.name.size());
+        appendChunk(out, SCENE_COMPONENT_CHUNK, static_cast<uint32_t>(owners.size()), type.dataSize, nameLength,
+                    [&](size_t payloadOffset) {
+            appendBytes(out, type.name.data(), nameLength);
+            padToAlignment(out, payloadOffset);
+            appendBytes(out, owners.data(), owners.size() * sizeof(uint32_t));
+            padToAlignment(out, payloadOffset);
+            appendBytes(out, data.data(), data.size());
+        });
+        ++header.chunkCount;
+    }
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+
+bool SceneSerializer::loadBinary(Scene& scene, const char* data, size_t size) const {
+    SceneFileHeader header;
+    if (size < sizeof(header)) {
+        LOG_ENGINE_CLASS_ERROR("Scene data is too small to be a scene");
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SceneFileHeader{}.magic, sizeof(header.magic)) != 0) {
+        LOG_ENGINE_CLASS_ERROR("Scene data has an invalid magic number");
+        return false;
+    }
+    if (header.version != SCENE_VERSION_1) {
+        LOG_ENGINE_CLASS_ERROR("Unsupported scene version: " + std::to_string(header.version));
+        return false;
+    }
+
+    std::vector<SceneEntityRecord> records;
+    bool hasEntities = false;
+    std::vector<LoadedComponents> components;
+
+    uint64_t offset = sizeof(header);
+    for (uint32_t chunkIndex = 0; chunkIndex < header.chunkCount; ++chunkIndex) {
+        SceneChunkHeader chunk;
+        offset = alignSceneOffset(offset);
+        if (offset > size || size - offset < sizeof(chunk)) {
+            LOG_ENGINE_CLASS_ERROR("Scene data is truncated");
+            return false;
+        }
+        std::memcpy(&chunk, data + offset, sizeof(chunk));
+        const uint64_t payloadOffset = offset + sizeof(chunk);
+        if (chunk.size > size - payloadOffset) {
+            LOG_ENGINE_CLASS_ERROR("Scene data is truncated");
+            return false;
+        }
+        const char* payload = data + payloadOffset;
+        offset = payloadOffset + chunk.size;
+
+        if (std::memcmp(chunk.tag, SCENE_ENTITY_CHUNK, sizeof(chunk.tag)) == 0) {
+            const uint64_t recordsSize = uint64_t(chunk.elementCount) * sizeof(SceneEntityRecord);
+            if (hasEntities || chunk.elementSize != sizeof(SceneEntityRecord) || recordsSize > chunk.size) {
+                LOG_ENGINE_CLASS_ERROR("Scene data has an invalid entity chunk");
+                return false;
+            }
+            records.resize(chunk.elementCount);
+            std::memcpy(records.data(), payload, recordsSize);
+            hasEntities = true;
+        } else if (std::memcmp(chunk.tag, SCENE_COMPONENT_CHUNK, sizeof(chunk.tag)) == 0) {
+            const uint64_t ownersOffset = alignSceneOffset(chunk.nameLength);
+            const uint64_t dataOffset = alignSceneOffset(ownersOffset + uint64_t(chunk.elementCount) * sizeof(uint32_t));
+            if (!hasEntities || dataOffset + uint64_t(chunk.elementCount) * chunk.elementSize > chunk.size) {
+                LOG_ENGINE_CLASS_ERROR("Scene data has an invalid component chunk");
+                return false;
+            }
+
+            std::string_view name(payload, chunk.nameLength);
+            const ComponentTypeInfo* type = m_registry.find(name);
+            if (!type) {
+                LOG_ENGINE_CLASS_WARNING("Skipping components of unregistered type: " + std::string(name));
+                continue;
+            }
+            if (type->dataSize != chunk.elementSize) {
+                LOG_ENGINE_CLASS_WARNING("Skipping components whose saved size does not match their type: " + std::string(name));
+                continue;
+            }
+
+            LoadedComponents loaded{type, std::vector<uint32_t>(chunk.elementCount), payload + dataOffset, {}};
+            std::memcpy(loaded.entities.data(), payload + ownersOffset, loaded.entities.size() * sizeof(uint32_t));
+            for (uint32_t owner : loaded.entities) {
+                if (owner >= records.size()) {
+                    LOG_ENGINE_CLASS_ERROR("Scene data has a component of a missing entity");
+                    return false;
+                }
+            }
+            components.push_back(std::move(loaded));
+        }
+        // Chunks of other kinds come from newer writers and are skipped
+    }
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].parent != SCENE_NO_PARENT && records[i].parent >= i) {
+            LOG_ENGINE_CLASS_ERROR("Scene data lists an entity before its parent");
+            return false;
+        }
+    }
+
+    instantiate(scene, records, components);
+    return true;
+}
+
+nlohmann::json SceneSerializer::saveJson(Scene& scene) const {
+    SavedEntities saved = collectEntities(scene);
+
+    nlohmann::json entities = nlohmann::json::array();
+    for (const SceneEntityRecord& record : saved.records) {
+        entities.push_back({
+            {"parent", record.parent == SCENE_NO_PARENT ? nlohmann::json(nullptr) : nlohmann::json(record.parent)},
+            {"active", (record.flags & SCENE_ENTITY_INACTIVE) == 0},
+            {"components", nlohmann::json::array()},
+        });
+    }
+
+    std::vector<uint32_t> owners;
+    std::vector<char> data;
+    for (const ComponentTypeInfo& type : m_registry.getTypes()) {
+        owners.clear();
+        data.clear();
+        collectComponents(scene, type, saved, owners, data);
+        for (size_t i = 0; i < owners.size(); ++i) {
+            entities[owners[i]]["components"].push_back({
+                {"type", type.name},
+                {"data", type.toJson(data.data() + i * type.dataSize)},
+            });
+        }
+    }
+
+    return {
+        {"version", SCENE_VERSION_1},
+        {"entities", std::move(entities)},
+    };
+}
+
+bool SceneSerializer::loadJson(Scene& scene, const nlohmann::json& json) const {
+    std::vector<SceneEntityRecord> records;
+    std::vector<LoadedComponents> components;
+
+    try {
+        uint32_t version = json.at("version").get<uint32_t>();
+        if (version != SCENE_VERSION_1) {
+            LOG_ENGINE_CLASS_ERROR("Unsupported scene version: " + std::to_string(version));
+            return false;
+        }
+
+        const nlohmann::json& entities = json.at("entities");
+        records.reserve(entities.size());
+        std::unordered_map<std::string, size_t> componentsByType;
+        for (const nlohmann::json& entity : entities) {
+            const uint32_t index = static_cast<uint32_t>(records.size());
+            const nlohmann::json& parent = entity.at("parent");
+            SceneEntityRecord record{SCENE_NO_PARENT, 0};
+            if (!parent.is_null()) {
+                record.parent = parent.get<uint32_t>();
+                if (record.parent >= index) {
+                    LOG_ENGINE_CLASS_ERROR("Scene JSON lists an entity before its parent");
+                    return false;
+                }
+            }
+            if (!entity.value("active", true)) {
+                record.flags |= SCENE_ENTITY_INACTIVE;
+            }
+            records.push_back(record);
+
+            for (const nlohmann::json& component : entity.value("components", nlohmann::json::array())) {
+                const std::string name = component.at("type").get<std::string>();
+                auto it = componentsByType.find(name);
+                if (it == componentsByType.end()) {
+                    const ComponentTypeInfo* type = m_registry.find(name);
+                    if (!type) {
+                        LOG_ENGINE_CLASS_WARNING("Skipping components of unregistered type: " + name);
+                    }
+                    it = componentsByType.emplace(name, components.size()).first;
+                    components.push_back({type, {}, nullptr, {}});
+                }
+
+                LoadedComponents& loaded = components[it->second];
+                if (!loaded.type) {
+                    continue;
+                }
+                loaded.entities.push_back(index);
+                loaded.ownedData.resize(loaded.ownedData.size() + loaded.type->dataSize);
+                loaded.type->fromJson(component.at("data"),
+                                      loaded.ownedData.data() + loaded.ownedData.size() - loaded.type->dataSize);
+            }
+        }
+    } catch (const nlohmann::json::exception& e) {
+        LOG_ENGINE_CLASS_ERROR(std::string("Invalid scene JSON: ") + e.what());
+        return false;
+    }
+
+    // Unknown types were kept only to warn about them once
+    std::erase_if(components, [](const LoadedComponents& loaded) { return !loaded.type; });
+    for (LoadedComponents& loaded : components) {
+        loaded.data = loaded.ownedData.data();
+    }
+
+    instantiate(scene, records, components);
+    return true;
+}
+
+bool SceneSerializer::saveFile(Scene& scene, const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ENGINE_CLASS_ERROR("Failed to open scene file for writing: " + path.string());
+        return false;
+    }
+
+    if (hasJsonExtension(path)) {
+        file << saveJson(scene).dump(2) << '\n';
+    } else {
+        std::vector<char> data = saveBinary(scene);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    if (!file) {
+        LOG_ENGINE_CLASS_ERROR("Failed to write scene file: " + path.string());
+        return false;
+    }
+    return true;
+}
+
+bool SceneSerializer::loadFile(Scene& scene, const std::filesystem::path& path) const {
+    if (hasJsonExtension(path)) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            LOG_ENGINE_CLASS_ERROR("Failed to open scene file: " + path.string());
+            return false;
+        }
+        nlohmann::json json = nlohmann::json::parse(file, nullptr, false);
+        if (json.is_discarded()) {
+            LOG_ENGINE_CLASS_ERROR("Failed to parse scene file: " + path.string());
+            return false;
+        }
+        return loadJson(scene, json);
+    }
+
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        LOG_ENGINE_CLASS_ERROR("Failed to open scene file: " + path.string());
+        return false;
+    }
+    return loadBinary(scene, file.data(), file.size());
+}
+
+} // namespace vroom
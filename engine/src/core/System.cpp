@@ -0,0 +1,99 @@
+#include "vroom/core/System.hpp"
+#include "vroom/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+namespace vroom {
+
+namespace {
+
+bool overlaps(const std::vector<ComponentTypeId>& a, const std::vector<ComponentTypeId>& b) {
+    return std::any_of(a.begin(), a.end(), [&b](ComponentTypeId type) {
+        return std::find(b.begin(), b.end(), type) != b.end();
+    });
+}
+
+} // namespace
+
+bool SystemAccess::conflictsWith(const SystemAccess& other) const {
+    return overlaps(writes, other.writes) || overlaps(writes, other.reads) || overlaps(reads, other.writes);
+}
+
+void SystemScheduler::buildGraph() {
+    size_t count = m_systems.size();
+    m_dependents.assign(count, {});
+    m_dependencyCounts.assign(count, 0);
+
+    for (size_t later = 0; later < count; ++later) {
+        for (size_t earlier = 0; earlier < later; ++earlier) {
+            if (m_systems[later]->getAccess().conflictsWith(m_systems[earlier]->getAccess())) {
+                m_dependents[earlier].push_back(later);
+                ++m_dependencyCounts[later];
+            }
+        }
+    }
+    m_graphDirty = false;
+}
+
+void SystemScheduler::run(Scene& scene, float deltaTime, JobSystem* jobs) {
+    if (!jobs || m_systems.size() < 2) {
+        std::exception_ptr error;
+        for (auto& system : m_systems) {
+            try {
+                system->update(scene, deltaTime);
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return;
+    }
+
+    if (m_graphDirty) {
+        buildGraph();
+    }
+
+    std::vector<std::atomic<size_t>> pending(m_systems.size());
+    for (size_t i = 0; i < m_systems.size(); ++i) {
+        pending[i].store(m_dependencyCounts[i], std::memory_order_relaxed);
+    }
+
+    // A finished system queues its released dependents before its own job ends, so the
+    // counter stays above zero until the whole graph has run
+    JobCounter counter;
+    std::function<void(size_t)> launch = [&](size_t index) {
+        jobs->run([&, index]() {
+            std::exception_ptr error;
+            try {
+                m_systems[index]->update(scene, deltaTime);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            for (size_t dependent : m_dependents[index]) {
+                if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    launch(dependent);
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }, &counter);
+    };
+
+    for (size_t i = 0; i < m_systems.size(); ++i) {
+        if (m_dependencyCounts[i] == 0) {
+            launch(i);
+        }
+    }
+    jobs->wait(counter);
+}
+
+} // namespace vroom
@@ -0,0 +1,26 @@
+#include "vroom/core/Transform.hpp"
+#include "vroom/core/Entity.hpp"
+#include "vroom/core/Scene.hpp"
+
+namespace vroom {
+
+Transform::~Transform() {
+    if (m_index != TransformStorage::InvalidIndex) {
+        m_storage->destroy(m_index);
+    }
+}
+
+void Transform::awake() {
+    Entity* entity = getEntity();
+    if (auto scene = entity->getScene()) {
+        m_storage = &scene->getTransforms();
+        m_index = m_storage->create(entity->getHandle());
+    } else {
+        // Never propagated, so it needs no owner to be found by
+        m_ownStorage = std::make_unique<TransformStorage>();
+        m_storage = m_ownStorage.get();
+        m_index = m_storage->create({});
+    }
+}
+
+} // namespace vroom
@@ -0,0 +1,197 @@
+#include "vroom/core/TransformStorage.hpp"
+#include "vroom/core/Scene.hpp"
+#include "vroom/core/SceneHierarchy.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VROOM_TRANSFORM_SSE 1
+#endif
+
+namespace vroom {
+
+namespace {
+
+// result = parent * local for column-major matrices. result must not alias either input.
+void multiplyMatrices(const glm::mat4& parent, const glm::mat4& local, glm::mat4& result) {
+#ifdef VROOM_TRANSFORM_SSE
+    // Each result column is the parent's columns weighted by one column of local
+    const float* a = &parent[0][0];
+    __m128 column0 = _mm_loadu_ps(a);
+    __m128 column1 = _mm_loadu_ps(a + 4);
+    __m128 column2 = _mm_loadu_ps(a + 8);
+    __m128 column3 = _mm_loadu_ps(a + 12);
+
+    const float* b = &local[0][0];
+    float* out = &result[0][0];
+    for (int column = 0; column < 4; ++column) {
+        const float* weights = b + column * 4;
+        __m128 sum = _mm_mul_ps(column0, _mm_set1_ps(weights[0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(column1, _mm_set1_ps(weights[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(column2, _mm_set1_ps(weights[2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(column3, _mm_set1_ps(weights[3])));
+        _mm_storeu_ps(out + column * 4, sum);
+    }
+#else
+    result = parent * local;
+#endif
+}
+
+} // namespace
+
+uint32_t TransformStorage::create(EntityHandle owner) {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_owners.size());
+        m_positions.emplace_back();
+        m_rotations.emplace_back();
+        m_scales.emplace_back();
+        m_localMatrices.emplace_back();
+        m_worldMatrices.emplace_back();
+        m_owners.emplace_back();
+        m_queued.emplace_back();
+    }
+
+    m_positions[index] = glm::vec3(0.0f);
+    m_rotations[index] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    m_scales[index] = glm::vec3(1.0f);
+    m_localMatrices[index] = glm::mat4(1.0f);
+    m_worldMatrices[index] = glm::mat4(1.0f);
+    m_owners[index] = owner;
+    m_queued[index] = false;
+    if (!owner.isNull()) {
+        if (owner.index >= m_slotIndices.size()) {
+            m_slotIndices.resize(owner.index + 1, InvalidIndex);
+        }
+        if (m_slotIndices[owner.index] == InvalidIndex) {
+            m_slotIndices[owner.index] = index;
+        }
+    }
+
+    // Its world matrix depends on the parents it already has
+    markDirty(owner);
+    m_queued[index] = true;
+    return index;
+}
+
+void TransformStorage::destroy(uint32_t index) {
+    // Children of an entity that loses its transform now build on the one above it
+    markDirty(m_owners[index]);
+    uint32_t slot = m_owners[index].index;
+    if (findBySlot(slot) == index) {
+        m_slotIndices[slot] = InvalidIndex;
+    }
+    m_owners[index] = {};
+    m_queued[index] = false;
+    m_freeIndices.push_back(index);
+}
+
+void TransformStorage::setPosition(uint32_t index, const glm::vec3& position) {
+    m_positions[index] = position;
+    onLocalChanged(index);
+}
+
+void TransformStorage::setRotation(uint32_t index, const glm::quat& rotation) {
+    m_rotations[index] = rotation;
+    onLocalChanged(index);
+}
+
+void TransformStorage::setScale(uint32_t index, const glm::vec3& scale) {
+    m_scales[index] = scale;
+    onLocalChanged(index);
+}
+
+void TransformStorage::onLocalChanged(uint32_t index) {
+    // Translation * rotation * scale
+    glm::mat4 matrix = glm::mat4_cast(m_rotations[index]);
+    matrix[0] *= m_scales[index].x;
+    matrix[1] *= m_scales[index].y;
+    matrix[2] *= m_scales[index].z;
+    matrix[3] = glm::vec4(m_positions[index], 1.0f);
+    m_localMatrices[index] = matrix;
+
+    // Queue the owner once however many local values change before the next propagate()
+    if (!m_queued[index]) {
+        markDirty(m_owners[index]);
+        m_queued[index] = true;
+    }
+}
+
+void TransformStorage::markDirty(EntityHandle entity) {
+    m_dirtyEntities.push_back(entity);
+}
+
+size_t TransformStorage::propagate(Scene& scene) {
+    if (m_dirtyEntities.empty()) {
+        return 0;
+    }
+
+    const SceneHierarchy& hierarchy = scene.getHierarchy();
+    m_dirtyPositions.clear();
+    for (EntityHandle handle : m_dirtyEntities) {
+        Entity* entity = scene.getEntity(handle);
+        if (!entity) {
+            continue;
+        }
+        uint32_t index = findBySlot(handle.index);
+        if (index != InvalidIndex) {
+            m_queued[index] = false;
+        }
+        uint32_t position = hierarchy.find(*entity);
+        if (position != SceneHierarchy::NoPosition) {
+            m_dirtyPositions.push_back(position);
+        }
+    }
+    m_dirtyEntities.clear();
+
+    // In hierarchy order, a dirty subtree inside another one is covered by the outer pass
+    std::sort(m_dirtyPositions.begin(), m_dirtyPositions.end());
+    size_t updated = 0;
+    size_t coveredEnd = 0;
+    for (uint32_t position : m_dirtyPositions) {
+        if (position < coveredEnd) {
+            continue;
+        }
+        coveredEnd = position + hierarchy.getSubtreeSize(position);
+        updated += propagateSubtree(hierarchy, position, coveredEnd);
+    }
+    return updated;
+}
+
+size_t TransformStorage::propagateSubtree(const SceneHierarchy& hierarchy, size_t begin, size_t end) {
+    // For each position, the transform whose world matrix its children build on
+    m_parentWorlds.resize(end - begin);
+
+    // The closest transform above the subtree, which is up to date as it is not dirty
+    uint32_t outerWorld = InvalidIndex;
+    for (uint32_t ancestor = hierarchy.getParent(begin); ancestor != SceneHierarchy::NoPosition && outerWorld == InvalidIndex;
+         ancestor = hierarchy.getParent(ancestor)) {
+        outerWorld = findBySlot(hierarchy.getSlot(ancestor));
+    }
+
+    size_t updated = 0;
+    for (size_t position = begin; position < end; ++position) {
+        uint32_t parentWorld = position == begin ? outerWorld : m_parentWorlds[hierarchy.getParent(position) - begin];
+        uint32_t index = findBySlot(hierarchy.getSlot(position));
+        if (index == InvalidIndex) {
+            // Entities without a transform pass their parent's through
+            m_parentWorlds[position - begin] = parentWorld;
+            continue;
+        }
+
+        if (parentWorld == InvalidIndex) {
+            m_worldMatrices[index] = m_localMatrices[index];
+        } else {
+            multiplyMatrices(m_worldMatrices[parentWorld], m_localMatrices[index], m_worldMatrices[index]);
+        }
+        m_parentWorlds[position - begin] = index;
+        ++updated;
+    }
+    return updated;
+}
+
+} // namespace vroom
@@ -1,4 +1,7 @@
 #include "vroom/vulkan/VulkanDevice.hpp"
+#include "vroom/core/Hash.hpp"
+#include "vroom/logging/LogMacros.hpp"
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <vector>
@@ -38,16 +41,33 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
     }
 }
 
-VulkanDevice::VulkanDevice(GLFWwindow* window) : m_window(window) {
+namespace {
+
+// The driver's cache blob is wrapped in this header so a truncated or damaged file is
+// rejected before it reaches the driver
+struct PipelineCacheFileHeader {
+    char magic[4] = {'V', 'R', 'P', 'C'}; // VRoom Pipeline Cache
+    uint32_t version = 1;
+    uint64_t dataSize = 0;
+    uint64_t checksum = 0;
+};
+
+} // namespace
+
+VulkanDevice::VulkanDevice(GLFWwindow* window, std::filesystem::path pipelineCachePath)
+    : m_window(window), m_pipelineCachePath(std::move(pipelineCachePath)) {
     createInstance();
     setupDebugMessenger();
     createSurface();
     pickPhysicalDevice();
     createLogicalDevice();
     createCommandPool();
+    createPipelineCache();
 }
 
 VulkanDevice::~VulkanDevice() {
+    savePipelineCache();
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
     vkDestroyDevice(m_device, nullptr);
 
@@ -205,6 +225,119 @@ void VulkanDevice::createCommandPool() {
     }
 }
 
+void VulkanDevice::createPipelineCache() {
+    std::vector<char> initialData = loadPipelineCacheData();
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_pipelineCache) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+std::vector<char> VulkanDevice::loadPipelineCacheData() const {
+    if (m_pipelineCachePath.empty()) {
+        return {};
+    }
+
+    std::ifstream file(m_pipelineCachePath, std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    PipelineCacheFileHeader header;
+    PipelineCacheFileHeader expected;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version) {
+        LOG_ENGINE_WARNING("Ignoring invalid pipeline cache file: " + m_pipelineCachePath.string());
+        return {};
+    }
+
+    // The size is untrusted; a torn or foreign file must not make us allocate whatever it says
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(m_pipelineCachePath, error);
+    if (error || header.dataSize > fileSize - sizeof(header)) {
+        LOG_ENGINE_WARNING("Ignoring truncated pipeline cache file: " + m_pipelineCachePath.string());
+        return {};
+    }
+
+    std::vector<char> data(header.dataSize);
+    file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!file || hashBytes(data.data(), data.size()) != header.checksum) {
+        LOG_ENGINE_WARNING("Ignoring corrupted pipeline cache file: " + m_pipelineCachePath.string());
+        return {};
+    }
+
+    // A cache from another GPU or driver version is useless at best, so check the
+    // header Vulkan puts at the start of every cache blob
+    VkPipelineCacheHeaderVersionOne cacheHeader;
+    if (data.size() < sizeof(cacheHeader)) {
+        return {};
+    }
+    std::memcpy(&cacheHeader, data.data(), sizeof(cacheHeader));
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    if (cacheHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        cacheHeader.vendorID != properties.vendorID ||
+        cacheHeader.deviceID != properties.deviceID ||
+        std::memcmp(cacheHeader.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        LOG_ENGINE_INFO("Pipeline cache was created by a different device or driver, starting fresh");
+        return {};
+    }
+
+    LOG_ENGINE_INFO("Loaded pipeline cache (" + std::to_string(data.size()) + " bytes)");
+    return data;
+}
+
+void VulkanDevice::savePipelineCache() const {
+    if (m_pipelineCachePath.empty() || m_pipelineCache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        return;
+    }
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+        LOG_ENGINE_WARNING("Failed to read pipeline cache data");
+        return;
+    }
+    data.resize(dataSize);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_pipelineCachePath.parent_path(), error);
+
+    // Write next to the target and rename, so a crash mid-write can't leave a torn file
+    auto tempPath = m_pipelineCachePath;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_ENGINE_WARNING("Failed to write pipeline cache file: " + m_pipelineCachePath.string());
+            return;
+        }
+
+        PipelineCacheFileHeader header;
+        header.dataSize = data.size();
+        header.checksum = hashBytes(data.data(), data.size());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::rename(tempPath, m_pipelineCachePath, error);
+    if (error) {
+        LOG_ENGINE_WARNING("Failed to write pipeline cache file: " + m_pipelineCachePath.string());
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
 QueueFamilyIndices VulkanDevice::findQueueFamilies(VkPhysicalDevice device) const {
     QueueFamilyIndices indices;
 
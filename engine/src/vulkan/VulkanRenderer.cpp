@@ -13,8 +13,8 @@
 
 namespace vroom {
 
-VulkanRenderer::VulkanRenderer(AssetManager& assetManager) 
-    : m_assetManager(assetManager) {
+VulkanRenderer::VulkanRenderer(AssetManager& assetManager, std::filesystem::path pipelineCachePath)
+    : m_assetManager(assetManager), m_pipelineCachePath(std::move(pipelineCachePath)) {
 }
 
 VulkanRenderer::~VulkanRenderer() {
@@ -50,7 +50,7 @@ VulkanRenderer::~VulkanRenderer() {
 void VulkanRenderer::init(GLFWwindow* window) {
     m_window = window;
     
-    m_device = std::make_unique<VulkanDevice>(window);
+    m_device = std::make_unique<VulkanDevice>(window, m_pipelineCachePath);
     m_swapChain = std::make_unique<VulkanSwapChain>(*m_device, window);
 
     createRenderPass();
@@ -135,9 +135,11 @@ void VulkanRenderer::createRenderPass() {
 }
 
 void VulkanRenderer::createGraphicsPipeline() {
-    // Use AssetManager to load shaders
-    auto vertShader = m_assetManager.getAsset<ShaderAsset>("shaders/shader.vert");
-    auto fragShader = m_assetManager.getAsset<ShaderAsset>("shaders/shader.frag");
+    // Compile every shader the pipeline needs in one batch, then take them from the cache
+    const std::vector<std::string> shaderPaths = {"shaders/shader.vert", "shaders/shader.frag"};
+    m_assetManager.preloadShaders(shaderPaths);
+    auto vertShader = m_assetManager.getAsset<ShaderAsset>(shaderPaths[0]);
+    auto fragShader = m_assetManager.getAsset<ShaderAsset>(shaderPaths[1]);
 
     if (!vertShader) {
         throw std::runtime_error("failed to load vertex shader: shaders/shader.vert");
@@ -242,7 +244,7 @@ void VulkanRenderer::createGraphicsPipeline() {
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-    if (vkCreateGraphicsPipelines(m_device->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS) {
+    if (vkCreateGraphicsPipelines(m_device->getDevice(), m_device->getPipelineCache(), 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS) {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
 
@@ -423,11 +425,21 @@ void VulkanRenderer::drawFrame() {
     m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
-VkShaderModule VulkanRenderer::createShaderModule(const std::vector<char>& code) {
+VkShaderModule VulkanRenderer::createShaderModule(const AssetView& code) {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     createInfo.codeSize = code.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    // pCode must be 4-byte aligned. Views into a package mapping usually are, but the
+    // package layout does not guarantee it, so fall back to an aligned copy if needed.
+    std::vector<uint32_t> alignedCode;
+    if (reinterpret_cast<uintptr_t>(code.data()) % alignof(uint32_t) == 0) {
+        createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+    } else {
+        alignedCode.resize((code.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        std::memcpy(alignedCode.data(), code.data(), code.size());
+        createInfo.pCode = alignedCode.data();
+    }
 
     VkShaderModule shaderModule;
     if (vkCreateShaderModule(m_device->getDevice(), &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
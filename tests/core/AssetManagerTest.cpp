@@ -4,9 +4,13 @@
 #include "vroom/asset/PackageFormat.hpp"
 #include "vroom/asset/ShaderAsset.hpp"
 #include "vroom/asset/ShaderCompiler.hpp"
+#include "vroom/core/JobSystem.hpp"
 #include <fstream>
 #include <filesystem>
 #include <cstring>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 namespace fs = std::filesystem;
 
@@ -24,11 +28,20 @@ public:
         const std::string& source,
         vroom::ShaderStage
     ) override {
-        // Return "compiled" data which is just source reversed
+        // Return "compiled" data which is just source reversed; empty source fails
+        compileCount++;
+        if (source.empty()) {
+            return std::nullopt;
+        }
         std::string compiled = source;
         std::reverse(compiled.begin(), compiled.end());
         return std::vector<char>(compiled.begin(), compiled.end());
     }
+
+    std::string getIdentity() const override { return identity; }
+
+    std::atomic<int> compileCount{0};
+    std::string identity = "mock 1.0";
 };
 
 class AssetManagerTest : public ::testing::Test {
@@ -53,6 +66,15 @@ protected:
 
         // Create a dummy package file
         createTestPackage(testDir / "assets.vpk");
+        createTestPackageV2(testDir / "assets_v2.vpk", {
+            {"pkg_file.txt", "Hello, Package v2!"},
+            {"subdir/data.bin", "DATA2"},
+            {"shaders/shader.vert.spv", std::string(64, 'S')},
+        });
+        createTestPackageV2(testDir / "assets_lz4.vpk", {
+            {"pkg_file.txt", "Hello, Hello, Hello, Hello, Compressed Package!"},
+            {"big.bin", std::string(100000, 'Z')},
+        }, true);
 
         manager = std::make_unique<vroom::AssetManager>();
         // Add Disk provider first
@@ -88,6 +110,51 @@ protected:
         out.close();
     }
 
+    void createTestPackageV2(const fs::path& path, std::vector<std::pair<std::string, std::string>> files, bool compress = false) {
+        std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+            return vroom::hashPackagePath(a.first) < vroom::hashPackagePath(b.first);
+        });
+
+        vroom::PackageHeaderV2 header;
+        header.fileCount = static_cast<uint32_t>(files.size());
+        header.tocOffset = sizeof(vroom::PackageHeaderV2);
+        header.stringTableOffset = header.tocOffset + files.size() * sizeof(vroom::PackageTocEntry);
+
+        std::string strings;
+        std::vector<vroom::PackageTocEntry> toc(files.size());
+        for (size_t i = 0; i < files.size(); ++i) {
+            toc[i].pathHash = vroom::hashPackagePath(files[i].first);
+            toc[i].pathOffset = static_cast<uint32_t>(strings.size());
+            toc[i].pathLength = static_cast<uint32_t>(files[i].first.size());
+            strings += files[i].first;
+        }
+        header.stringTableSize = strings.size();
+
+        std::string data;
+        uint64_t dataStart = header.stringTableOffset + header.stringTableSize;
+        for (size_t i = 0; i < files.size(); ++i) {
+            uint64_t offset = vroom::alignPackageOffset(dataStart + data.size(), vroom::PACKAGE_DATA_ALIGNMENT);
+            data.resize(offset - dataStart, '\0');
+            std::string stored = files[i].second;
+            if (compress) {
+                stored.resize(vroom::lz4CompressBound(files[i].second.size()));
+                stored.resize(vroom::lz4Compress(files[i].second.data(), files[i].second.size(), stored.data(), stored.size()));
+                toc[i].codec = vroom::PackageCodec::LZ4;
+            }
+            toc[i].offset = offset;
+            toc[i].storedSize = stored.size();
+            toc[i].size = files[i].second.size();
+            toc[i].checksum = vroom::hashPackageData(stored.data(), stored.size());
+            data += stored;
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(vroom::PackageTocEntry));
+        out.write(strings.data(), strings.size());
+        out.write(data.data(), data.size());
+    }
+
     void TearDown() override {
         if (fs::exists(testDir)) {
             fs::remove_all(testDir);
@@ -174,6 +241,32 @@ TEST_F(AssetManagerTest, ShaderCompilation) {
     EXPECT_EQ(actual, expected);
 }
 
+TEST_F(AssetManagerTest, PreloadShadersCompilesOneBatchIntoTheCache) {
+    auto mock = std::make_unique<MockShaderCompiler>();
+    auto* compiler = mock.get();
+    manager->setShaderCompiler(std::move(mock));
+    {
+        std::ofstream shader(testDir / "test.frag");
+        shader << "frag";
+    }
+
+    EXPECT_EQ(manager->preloadShaders({"test.vert", "test.frag", "missing.vert"}), 2u);
+    EXPECT_EQ(compiler->compileCount.load(), 2);
+
+    // No loader is registered, so these can only come from the cache
+    auto vert = manager->getAsset<vroom::ShaderAsset>("test.vert");
+    auto frag = manager->getAsset<vroom::ShaderAsset>("test.frag");
+    ASSERT_NE(vert, nullptr);
+    ASSERT_NE(frag, nullptr);
+    EXPECT_EQ(vert->getStage(), vroom::ShaderStage::Vertex);
+    EXPECT_EQ(frag->getStage(), vroom::ShaderStage::Fragment);
+    EXPECT_EQ(std::string(frag->getData().begin(), frag->getData().end()), "garf");
+
+    // Cached shaders are not compiled again
+    EXPECT_EQ(manager->preloadShaders({"test.vert"}), 0u);
+    EXPECT_EQ(compiler->compileCount.load(), 2);
+}
+
 TEST_F(AssetManagerTest, PackageLoading) {
     // Register package provider
     manager->addProvider(std::make_unique<vroom::PackageAssetProvider>(testDir / "assets.vpk"));
@@ -231,3 +324,522 @@ TEST_F(AssetManagerTest, PackagePrecedence) {
     ASSERT_NE(asset2, nullptr);
     EXPECT_EQ(asset2->content, "Hello, Package!");
 }
+
+TEST_F(AssetManagerTest, PackageMemoryMappedViews) {
+    vroom::PackageAssetProvider provider(testDir / "assets.vpk");
+    ASSERT_EQ(provider.getAccessMode(), vroom::PackageAccessMode::MemoryMapped);
+
+    auto view1 = provider.viewFile("pkg_file.txt");
+    auto view2 = provider.viewFile("pkg_file.txt");
+    EXPECT_EQ(std::string(view1.begin(), view1.end()), "Hello, Package!");
+
+    // Both views point into the same mapping rather than separate copies
+    EXPECT_EQ(view1.data(), view2.data());
+
+    auto data = provider.readFile("subdir/data.bin");
+    EXPECT_EQ(std::string(data.begin(), data.end()), "DATA");
+
+    EXPECT_TRUE(provider.viewFile("missing.txt").empty());
+}
+
+TEST_F(AssetManagerTest, PackageViewOutlivesProvider) {
+    vroom::AssetView view;
+    {
+        vroom::PackageAssetProvider provider(testDir / "assets.vpk");
+        view = provider.viewFile("subdir/data.bin");
+    }
+    EXPECT_EQ(std::string(view.begin(), view.end()), "DATA");
+}
+
+TEST_F(AssetManagerTest, PackageStreamMode) {
+    vroom::PackageAssetProvider provider(testDir / "assets.vpk", vroom::PackageAccessMode::Stream);
+    EXPECT_EQ(provider.getAccessMode(), vroom::PackageAccessMode::Stream);
+
+    auto view = provider.viewFile("pkg_file.txt");
+    EXPECT_EQ(std::string(view.begin(), view.end()), "Hello, Package!");
+}
+
+TEST_F(AssetManagerTest, ViewLoaderReceivesPackageBytes) {
+    manager->clearProviders();
+    auto provider = std::make_unique<vroom::PackageAssetProvider>(testDir / "assets.vpk");
+    const char* mappedBytes = provider->viewFile("pkg_file.txt").data();
+    manager->addProvider(std::move(provider));
+
+    const char* loaderBytes = nullptr;
+    manager->registerLoader<TestAsset>([&loaderBytes](const vroom::AssetView& data, const std::string&) {
+        loaderBytes = data.data();
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    auto asset = manager->getAsset<TestAsset>("pkg_file.txt");
+    ASSERT_NE(asset, nullptr);
+    EXPECT_EQ(asset->content, "Hello, Package!");
+    EXPECT_EQ(loaderBytes, mappedBytes);
+}
+
+TEST_F(AssetManagerTest, PackageV2Lookup) {
+    for (auto mode : {vroom::PackageAccessMode::MemoryMapped, vroom::PackageAccessMode::Stream}) {
+        vroom::PackageAssetProvider provider(testDir / "assets_v2.vpk", mode);
+        EXPECT_EQ(provider.getVersion(), vroom::PACKAGE_VERSION_2);
+        EXPECT_EQ(provider.getFileCount(), 3);
+
+        EXPECT_TRUE(provider.exists("pkg_file.txt"));
+        EXPECT_TRUE(provider.exists(fs::path("subdir") / "data.bin"));
+        EXPECT_FALSE(provider.exists("subdir"));
+        EXPECT_FALSE(provider.exists("missing.txt"));
+
+        auto data = provider.readFile("pkg_file.txt");
+        EXPECT_EQ(std::string(data.begin(), data.end()), "Hello, Package v2!");
+
+        auto view = provider.viewFile("subdir/data.bin");
+        EXPECT_EQ(std::string(view.begin(), view.end()), "DATA2");
+
+        EXPECT_TRUE(provider.verifyChecksums());
+    }
+}
+
+TEST_F(AssetManagerTest, PackageV2DataIsAligned) {
+    vroom::PackageAssetProvider provider(testDir / "assets_v2.vpk");
+    ASSERT_EQ(provider.getAccessMode(), vroom::PackageAccessMode::MemoryMapped);
+
+    auto view = provider.viewFile("shaders/shader.vert.spv");
+    ASSERT_EQ(view.size(), 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data()) % vroom::PACKAGE_DATA_ALIGNMENT, 0);
+}
+
+TEST_F(AssetManagerTest, PackageV2DetectsCorruption) {
+    auto path = testDir / "assets_v2.vpk";
+    {
+        // Flip the last byte of the data section
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    vroom::PackageAssetProvider provider(path);
+    EXPECT_TRUE(provider.exists("pkg_file.txt"));
+    EXPECT_FALSE(provider.verifyChecksums());
+}
+
+TEST_F(AssetManagerTest, PackageV1StillSupported) {
+    vroom::PackageAssetProvider provider(testDir / "assets.vpk");
+    EXPECT_EQ(provider.getVersion(), vroom::PACKAGE_VERSION_1);
+    EXPECT_EQ(provider.getFileCount(), 2);
+    EXPECT_TRUE(provider.verifyChecksums());
+}
+
+TEST_F(AssetManagerTest, PackageV1RejectsOversizedFileCount) {
+    auto path = testDir / "oversized_v1.vpk";
+    {
+        // Claims about 1 TB of entries, but holds a single one
+        std::ofstream out(path, std::ios::binary);
+        vroom::PackageHeader header;
+        header.fileCount = 0xFFFFFFFF;
+        vroom::PackageFileEntry entry;
+        std::strncpy(entry.path, "pkg_file.txt", sizeof(entry.path));
+        out.write(reinterpret_cast<char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<char*>(&entry), sizeof(entry));
+    }
+
+    std::unique_ptr<vroom::PackageAssetProvider> provider;
+    ASSERT_NO_THROW(provider = std::make_unique<vroom::PackageAssetProvider>(path));
+    EXPECT_EQ(provider->getFileCount(), 0);
+    EXPECT_FALSE(provider->exists("pkg_file.txt"));
+}
+
+TEST_F(AssetManagerTest, Lz4RoundTrip) {
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += "asset " + std::to_string(i % 37) + ";";
+    }
+
+    std::vector<char> compressed(vroom::lz4CompressBound(input.size()));
+    size_t compressedSize = vroom::lz4Compress(input.data(), input.size(), compressed.data(), compressed.size());
+    ASSERT_GT(compressedSize, 0);
+    EXPECT_LT(compressedSize, input.size());
+
+    std::string output(input.size(), '\0');
+    ASSERT_TRUE(vroom::lz4Decompress(compressed.data(), compressedSize, output.data(), output.size()));
+    EXPECT_EQ(output, input);
+
+    // Wrong expected size and truncated input are rejected
+    EXPECT_FALSE(vroom::lz4Decompress(compressed.data(), compressedSize, output.data(), output.size() - 1));
+    EXPECT_FALSE(vroom::lz4Decompress(compressed.data(), compressedSize - 1, output.data(), output.size()));
+
+    // Output that doesn't fit the capacity reports failure
+    EXPECT_EQ(vroom::lz4Compress(input.data(), input.size(), compressed.data(), 8), 0);
+}
+
+TEST_F(AssetManagerTest, PackageCompressedEntries) {
+    for (auto mode : {vroom::PackageAccessMode::MemoryMapped, vroom::PackageAccessMode::Stream}) {
+        vroom::PackageAssetProvider provider(testDir / "assets_lz4.vpk", mode);
+        ASSERT_EQ(provider.getFileCount(), 2);
+
+        auto data = provider.readFile("pkg_file.txt");
+        EXPECT_EQ(std::string(data.begin(), data.end()), "Hello, Hello, Hello, Hello, Compressed Package!");
+
+        auto view = provider.viewFile("big.bin");
+        ASSERT_EQ(view.size(), 100000);
+        EXPECT_EQ(std::string(view.begin(), view.end()), std::string(100000, 'Z'));
+
+        EXPECT_TRUE(provider.verifyChecksums());
+    }
+
+    EXPECT_LT(fs::file_size(testDir / "assets_lz4.vpk"), 10000);
+}
+
+TEST_F(AssetManagerTest, LoadAssetAsync) {
+    manager->registerLoader<TestAsset>([](const std::vector<char>& data, const std::string&) {
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    auto future = manager->loadAssetAsync<TestAsset>("test.txt");
+    auto asset = future.get();
+    ASSERT_NE(asset, nullptr);
+    EXPECT_EQ(asset->content, "Hello, Asset!");
+
+    // Cached assets resolve immediately to the same instance
+    auto cachedFuture = manager->loadAssetAsync<TestAsset>("test.txt");
+    EXPECT_EQ(cachedFuture.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(cachedFuture.get(), asset);
+
+    EXPECT_EQ(manager->loadAssetAsync<TestAsset>("nonexistent.txt").get(), nullptr);
+}
+
+TEST_F(AssetManagerTest, SlowLoadDoesNotBlockCachedLookups) {
+    std::atomic<bool> releaseSlowLoad{false};
+    std::atomic<bool> slowLoadStarted{false};
+
+    manager->registerLoader<TestAsset>([&](const std::vector<char>& data, const std::string& path) {
+        if (path == "test.vert") {
+            slowLoadStarted = true;
+            while (!releaseSlowLoad) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    ASSERT_NE(manager->getAsset<TestAsset>("test.txt"), nullptr);
+
+    auto slow = manager->loadAssetAsync<TestAsset>("test.vert");
+    while (!slowLoadStarted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Another asset can be fetched while the slow one is still decoding
+    auto fast = manager->getAsset<TestAsset>("test.txt");
+    ASSERT_NE(fast, nullptr);
+    EXPECT_EQ(fast->content, "Hello, Asset!");
+
+    releaseSlowLoad = true;
+    ASSERT_NE(slow.get(), nullptr);
+}
+
+TEST_F(AssetManagerTest, LoaderCanLoadDependencies) {
+    // Loading happens outside the cache lock, so a loader may request other assets
+    manager->registerLoader<TestAsset>([this](const std::vector<char>& data, const std::string& path) {
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        if (path == "test.vert") {
+            auto dependency = manager->getAsset<TestAsset>("test.txt");
+            asset->content += dependency ? dependency->content : "";
+        }
+        return asset;
+    });
+
+    auto asset = manager->getAsset<TestAsset>("test.vert");
+    ASSERT_NE(asset, nullptr);
+    EXPECT_EQ(asset->content, "void main() {}Hello, Asset!");
+}
+
+TEST_F(AssetManagerTest, ConcurrentRequestsShareOneLoad) {
+    std::atomic<bool> releaseLoad{false};
+    std::atomic<int> loaderCalls{0};
+
+    manager->registerLoader<TestAsset>([&](const std::vector<char>& data, const std::string&) {
+        loaderCalls++;
+        while (!releaseLoad) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    constexpr int threadCount = 8;
+    constexpr int asyncCount = 4;
+    std::vector<std::shared_ptr<TestAsset>> results(threadCount);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&, i]() { results[i] = manager->getAsset<TestAsset>("test.txt"); });
+    }
+
+    // Async requests issued while the load is pending join it without needing a free worker
+    while (loaderCalls == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::vector<std::future<std::shared_ptr<TestAsset>>> futures;
+    for (int i = 0; i < asyncCount; ++i) {
+        futures.push_back(manager->loadAssetAsync<TestAsset>("test.txt"));
+    }
+
+    // Every request but the first should join the pending load
+    while (manager->getStats().coalescedRequests < threadCount + asyncCount - 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    releaseLoad = true;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_NE(results[0], nullptr);
+    for (const auto& result : results) {
+        EXPECT_EQ(result, results[0]);
+    }
+    for (auto& future : futures) {
+        EXPECT_EQ(future.get(), results[0]);
+    }
+
+    EXPECT_EQ(loaderCalls, 1);
+    auto stats = manager->getStats();
+    EXPECT_EQ(stats.loads, 1u);
+    EXPECT_EQ(stats.coalescedRequests, static_cast<uint64_t>(threadCount + asyncCount - 1));
+}
+
+TEST_F(AssetManagerTest, CacheStats) {
+    manager->registerLoader<TestAsset>([](const std::vector<char>& data, const std::string& path) -> std::shared_ptr<TestAsset> {
+        if (path == "test.vert") {
+            return nullptr;
+        }
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    manager->getAsset<TestAsset>("test.txt");
+    manager->getAsset<TestAsset>("test.txt");
+    manager->getAsset<TestAsset>("test.vert");
+
+    auto stats = manager->getStats();
+    EXPECT_EQ(stats.loads, 2u);
+    EXPECT_EQ(stats.cacheHits, 1u);
+    EXPECT_EQ(stats.failedLoads, 1u);
+    EXPECT_EQ(stats.coalescedRequests, 0u);
+}
+
+TEST_F(AssetManagerTest, MemoryBudgetEvictsLeastRecentlyUsed) {
+    manager->registerLoader<TestAsset>([](const std::vector<char>& data, const std::string&) {
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+
+    // Room for exactly one cached asset
+    manager->setMemoryBudget(sizeof(TestAsset));
+
+    manager->getAsset<TestAsset>("test.txt");
+    manager->getAsset<TestAsset>("test.vert");
+
+    auto stats = manager->getStats();
+    EXPECT_EQ(stats.residentAssets, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+
+    // The older asset was evicted and has to be loaded again
+    manager->getAsset<TestAsset>("test.vert");
+    manager->getAsset<TestAsset>("test.txt");
+    stats = manager->getStats();
+    EXPECT_EQ(stats.loads, 3u);
+    EXPECT_EQ(stats.cacheHits, 1u);
+    EXPECT_LE(stats.residentBytes, manager->getMemoryBudget());
+}
+
+TEST_F(AssetManagerTest, MemoryBudgetKeepsReferencedAssets) {
+    manager->registerLoader<TestAsset>([](const std::vector<char>& data, const std::string&) {
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+    manager->setMemoryBudget(1);
+
+    auto held = manager->getAsset<TestAsset>("test.txt");
+    manager->getAsset<TestAsset>("test.vert");
+    manager->trimCache();
+
+    // The held asset stays cached, the unreferenced one does not
+    EXPECT_EQ(manager->getAsset<TestAsset>("test.txt"), held);
+    EXPECT_EQ(manager->getStats().residentAssets, 1u);
+
+    held.reset();
+    manager->trimCache();
+    EXPECT_EQ(manager->getStats().residentAssets, 0u);
+    EXPECT_EQ(manager->getStats().residentBytes, 0u);
+}
+
+TEST_F(AssetManagerTest, PinnedAssetsStayResident) {
+    manager->registerLoader<TestAsset>([](const std::vector<char>& data, const std::string&) {
+        auto asset = std::make_shared<TestAsset>();
+        asset->content = std::string(data.begin(), data.end());
+        return asset;
+    });
+    manager->setMemoryBudget(1);
+
+    manager->pinAsset("test.txt");
+    manager->getAsset<TestAsset>("test.txt");
+    manager->trimCache();
+    EXPECT_EQ(manager->getStats().residentAssets, 1u);
+
+    manager->unpinAsset("test.txt");
+    EXPECT_EQ(manager->getStats().residentAssets, 0u);
+}
+
+TEST_F(AssetManagerTest, ShaderCacheReusesCompiledBinaries) {
+    auto cacheDir = testDir / "shader_cache";
+    auto mock = std::make_unique<MockShaderCompiler>();
+    auto* inner = mock.get();
+    vroom::CachingShaderCompiler compiler(std::move(mock), cacheDir);
+
+    auto first = compiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    auto second = compiler.compile("b.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(first && second);
+    EXPECT_EQ(*first, *second);
+    EXPECT_EQ(inner->compileCount.load(), 1);
+    EXPECT_TRUE(fs::exists(compiler.getCachePath("void main() {}", vroom::ShaderStage::Vertex)));
+
+    // A fresh compiler (next startup) loads from disk without compiling
+    auto restarted = std::make_unique<MockShaderCompiler>();
+    auto* restartedInner = restarted.get();
+    vroom::CachingShaderCompiler restartedCompiler(std::move(restarted), cacheDir);
+    auto cached = restartedCompiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(cached);
+    EXPECT_EQ(*cached, *first);
+    EXPECT_EQ(restartedInner->compileCount.load(), 0);
+}
+
+TEST_F(AssetManagerTest, ShaderCacheKeyCoversSourceStageAndCompiler) {
+    auto cacheDir = testDir / "shader_cache";
+    auto mock = std::make_unique<MockShaderCompiler>();
+    auto* inner = mock.get();
+    vroom::CachingShaderCompiler compiler(std::move(mock), cacheDir);
+
+    (void)compiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    (void)compiler.compile("a.vert", "void main() { }", vroom::ShaderStage::Vertex);
+    (void)compiler.compile("a.frag", "void main() {}", vroom::ShaderStage::Fragment);
+    EXPECT_EQ(inner->compileCount.load(), 3);
+
+    auto upgraded = std::make_unique<MockShaderCompiler>();
+    upgraded->identity = "mock 2.0";
+    auto* upgradedInner = upgraded.get();
+    vroom::CachingShaderCompiler upgradedCompiler(std::move(upgraded), cacheDir);
+    (void)upgradedCompiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    EXPECT_EQ(upgradedInner->compileCount.load(), 1);
+}
+
+TEST_F(AssetManagerTest, ShaderCacheRejectsCorruptedEntries) {
+    auto cacheDir = testDir / "shader_cache";
+    auto mock = std::make_unique<MockShaderCompiler>();
+    auto* inner = mock.get();
+    vroom::CachingShaderCompiler compiler(std::move(mock), cacheDir);
+
+    auto original = compiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(original);
+
+    auto cachePath = compiler.getCachePath("void main() {}", vroom::ShaderStage::Vertex);
+    {
+        std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    auto recompiled = compiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(recompiled);
+    EXPECT_EQ(*recompiled, *original);
+    EXPECT_EQ(inner->compileCount.load(), 2);
+
+    // A size far beyond the file is rejected before anything is allocated for it
+    {
+        std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t size = UINT64_MAX / 2;
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+
+    recompiled = compiler.compile("a.vert", "void main() {}", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(recompiled);
+    EXPECT_EQ(*recompiled, *original);
+    EXPECT_EQ(inner->compileCount.load(), 3);
+}
+
+TEST_F(AssetManagerTest, CompileBatchKeepsJobOrder) {
+    MockShaderCompiler compiler;
+
+    std::vector<vroom::ShaderCompileJob> jobs;
+    for (int i = 0; i < 32; ++i) {
+        jobs.push_back({"shader" + std::to_string(i) + ".vert", "source " + std::to_string(i), vroom::ShaderStage::Vertex});
+    }
+    jobs.push_back({"broken.frag", "", vroom::ShaderStage::Fragment});
+
+    vroom::JobSystem jobSystem(4);
+    auto results = compiler.compileBatch(jobs, jobSystem);
+    ASSERT_EQ(results.size(), jobs.size());
+    for (size_t i = 0; i + 1 < jobs.size(); ++i) {
+        ASSERT_TRUE(results[i].succeeded());
+        std::string expected = jobs[i].sourceCode;
+        std::reverse(expected.begin(), expected.end());
+        EXPECT_EQ(std::string(results[i].binary->begin(), results[i].binary->end()), expected);
+    }
+
+    EXPECT_FALSE(results.back().succeeded());
+    EXPECT_FALSE(results.back().diagnostics.empty());
+    EXPECT_EQ(compiler.compileCount.load(), static_cast<int>(jobs.size()));
+}
+
+TEST_F(AssetManagerTest, ShaderCacheCompileBatchOnlyCompilesMisses) {
+    auto mock = std::make_unique<MockShaderCompiler>();
+    auto* inner = mock.get();
+    vroom::CachingShaderCompiler compiler(std::move(mock), testDir / "shader_cache");
+
+    (void)compiler.compile("a.vert", "cached", vroom::ShaderStage::Vertex);
+
+    std::vector<vroom::ShaderCompileJob> jobs = {
+        {"a.vert", "cached", vroom::ShaderStage::Vertex},
+        {"b.vert", "fresh", vroom::ShaderStage::Vertex},
+        {"c.frag", "also fresh", vroom::ShaderStage::Fragment},
+    };
+    vroom::JobSystem jobSystem(2);
+    auto results = compiler.compileBatch(jobs, jobSystem);
+    ASSERT_EQ(results.size(), 3u);
+    for (const auto& result : results) {
+        EXPECT_TRUE(result.succeeded());
+    }
+    EXPECT_EQ(std::string(results[1].binary->begin(), results[1].binary->end()), "hserf");
+    EXPECT_EQ(inner->compileCount.load(), 3);
+
+    // Everything is cached now
+    (void)compiler.compileBatch(jobs, jobSystem);
+    EXPECT_EQ(inner->compileCount.load(), 3);
+}
+
+#if defined(VROOM_WITH_SHADERC)
+TEST_F(AssetManagerTest, ShadercCompilesInProcess) {
+    vroom::ShadercShaderCompiler compiler;
+
+    auto spv = compiler.compile("test.vert", "#version 450\nvoid main() { gl_Position = vec4(0.0); }\n", vroom::ShaderStage::Vertex);
+    ASSERT_TRUE(spv);
+    ASSERT_GE(spv->size(), 4u);
+    EXPECT_EQ(spv->size() % 4, 0u);
+
+    uint32_t magic;
+    std::memcpy(&magic, spv->data(), sizeof(magic));
+    EXPECT_EQ(magic, 0x07230203u);
+
+    EXPECT_FALSE(compiler.compile("broken.frag", "#version 450\nvoid main() {", vroom::ShaderStage::Fragment));
+    EXPECT_FALSE(compiler.getIdentity().empty());
+}
+#endif
@@ -1,11 +1,7 @@
 #include <gtest/gtest.h>
 #include "vroom/core/Component.hpp"
 #include "vroom/core/Entity.hpp"
-
-// Mock Scene for Entity
-namespace vroom {
-class Scene {};
-}
+#include "vroom/core/Scene.hpp"
 
 class LifecycleComponent : public vroom::Component {
 public:
@@ -62,18 +58,18 @@ TEST(ComponentLifecycleTest, AddComponentCallsAwakeAndOnEnable) {
     EXPECT_TRUE(comp.isEnabled());
 }
 
-TEST(ComponentLifecycleTest, EntityUpdateCallsStartAndUpdate) {
-    vroom::Entity entity(1, nullptr);
-    auto& comp = entity.addComponent<LifecycleComponent>();
+TEST(ComponentLifecycleTest, SceneUpdateCallsStartAndUpdate) {
+    auto scene = std::make_shared<vroom::Scene>();
+    auto& comp = scene->createEntity().addComponent<LifecycleComponent>();
     
     // First update: Start + Update
-    entity.update(0.1f);
+    scene->update(0.1f);
     EXPECT_EQ(comp.startCount, 1);
     EXPECT_EQ(comp.updateCount, 1);
     EXPECT_TRUE(comp.hasStarted());
 
     // Second update: Update only
-    entity.update(0.1f);
+    scene->update(0.1f);
     EXPECT_EQ(comp.startCount, 1);
     EXPECT_EQ(comp.updateCount, 2);
 }
@@ -165,12 +161,12 @@ public:
 };
 
 TEST(ComponentLifecycleTest, DisableInStartPreventsUpdate) {
-    vroom::Entity entity(1, nullptr);
-    auto& comp = entity.addComponent<SelfDisablingComponent>();
+    auto scene = std::make_shared<vroom::Scene>();
+    auto& comp = scene->createEntity().addComponent<SelfDisablingComponent>();
     
     // First update: triggers start(). Component disables itself.
     // If bug exists, update() will still be called this frame.
-    entity.update(0.1f);
+    scene->update(0.1f);
     
     EXPECT_EQ(comp.startCount, 1);
     EXPECT_EQ(comp.updateCount, 0) << "Update should not be called if disabled in start()";
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "vroom/core/Scene.hpp"
+#include "vroom/core/EntityCommandBuffer.hpp"
+#include "vroom/core/JobSystem.hpp"
+
+#include <vector>
+
+using namespace vroom;
+
+class EntityCommandBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene = std::make_shared<Scene>();
+    }
+
+    std::shared_ptr<Scene> scene;
+};
+
+struct SpawnedComponent : public Component {
+    explicit SpawnedComponent(int value) : value(value) {}
+    int value;
+};
+
+struct TagComponent : public Component {};
+
+TEST_F(EntityCommandBufferTest, PlaceholdersResolveToCreatedEntities) {
+    Entity& existing = scene->createEntity();
+
+    EntityCommandBuffer commands;
+    EntityHandle parent = commands.createEntity();
+    EntityHandle child = commands.createEntity();
+    commands.addComponent<SpawnedComponent>(child, 7);
+    commands.setParent(child, parent);
+    commands.setParent(existing.getHandle(), parent);
+    EXPECT_FALSE(scene->isValid(parent));
+    EXPECT_EQ(scene->getEntityCount(), 1);
+
+    scene->submitCommands(std::move(commands));
+    scene->playbackCommands();
+
+    EXPECT_EQ(scene->getEntityCount(), 3);
+    auto roots = scene->getRootEntities();
+    ASSERT_EQ(roots.size(), 1);
+    ASSERT_EQ(roots[0]->getChildren().size(), 2);
+    Entity* spawned = roots[0]->getChild(0);
+    ASSERT_NE(spawned->getComponent<SpawnedComponent>(), nullptr);
+    EXPECT_EQ(spawned->getComponent<SpawnedComponent>()->value, 7);
+    EXPECT_EQ(existing.getParent(), roots[0]);
+}
+
+TEST_F(EntityCommandBufferTest, RemoveAndDestroyUpdateQueries) {
+    Entity& kept = scene->createEntity();
+    Entity& stripped = scene->createEntity();
+    Entity& destroyed = scene->createEntity();
+    for (Entity* entity : {&kept, &stripped, &destroyed}) {
+        entity->addComponent<TagComponent>();
+    }
+    auto query = scene->query<TagComponent>();
+    ASSERT_EQ(query.size(), 3);
+
+    EntityCommandBuffer commands;
+    commands.removeComponent<TagComponent>(stripped.getHandle());
+    commands.destroyEntity(destroyed.getHandle());
+    // Stale handles are skipped
+    commands.addComponent<TagComponent>(destroyed.getHandle());
+    scene->submitCommands(std::move(commands));
+
+    scene->update(0.016f);
+    EXPECT_EQ(stripped.getComponent<TagComponent>(), nullptr);
+    EXPECT_EQ(scene->getEntityCount(), 2);
+    std::vector<Entity*> visited;
+    query.each([&visited](Entity& entity, TagComponent&) { visited.push_back(&entity); });
+    EXPECT_EQ(visited, std::vector<Entity*>{&kept});
+}
+
+TEST_F(EntityCommandBufferTest, ParallelRecordingPlaysBackInSortKeyOrder) {
+    JobSystem jobs(4);
+    constexpr size_t JobCount = 64;
+    jobs.parallelFor(JobCount, [this](size_t i) {
+        EntityCommandBuffer commands(i);
+        EntityHandle entity = commands.createEntity();
+        commands.addComponent<SpawnedComponent>(entity, static_cast<int>(i));
+        scene->submitCommands(std::move(commands));
+    });
+    EXPECT_EQ(scene->getEntityCount(), 0);
+
+    scene->playbackCommands();
+    ASSERT_EQ(scene->getEntityCount(), JobCount);
+
+    // Entities were created in key order whichever worker submitted first
+    std::vector<int> values;
+    for (Entity* entity : scene->getRootEntities()) {
+        values.push_back(entity->getComponent<SpawnedComponent>()->value);
+    }
+    for (size_t i = 0; i < JobCount; ++i) {
+        EXPECT_EQ(values[i], static_cast<int>(i));
+    }
+}
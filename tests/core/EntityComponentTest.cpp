@@ -1,11 +1,7 @@
 #include <gtest/gtest.h>
 #include "vroom/core/Entity.hpp"
 #include "vroom/core/Component.hpp"
-
-// Mock Scene since we don't have a definition yet
-namespace vroom {
-class Scene {};
-}
+#include "vroom/core/Scene.hpp"
 
 class PositionComponent : public vroom::Component {
 public:
@@ -97,3 +93,105 @@ TEST(EntityComponentTest, ComponentInheritance) {
     EXPECT_EQ(baseScript->getName(), "MyScript");
 }
 
+
+TEST(EntityComponentTest, ComponentTypeIdsAreStable) {
+    EXPECT_EQ(vroom::componentTypeId<PositionComponent>(), vroom::componentTypeId<PositionComponent>());
+    EXPECT_NE(vroom::componentTypeId<PositionComponent>(), vroom::componentTypeId<VelocityComponent>());
+
+    vroom::Entity entity(1, nullptr);
+    entity.addComponent<PositionComponent>(0.0f, 0.0f, 0.0f);
+    EXPECT_TRUE(entity.getComponentMask().test(vroom::componentTypeId<PositionComponent>()));
+    EXPECT_FALSE(entity.getComponentMask().test(vroom::componentTypeId<VelocityComponent>()));
+}
+
+TEST(EntityComponentTest, BaseLookupIgnoresUnrelatedComponents) {
+    vroom::Entity entity(1, nullptr);
+    entity.addComponent<PositionComponent>(1.0f, 2.0f, 3.0f);
+    EXPECT_EQ(entity.getComponent<BaseScript>(), nullptr);
+
+    auto& script = entity.addComponent<MyScript>();
+    // Answered from the cached derivation table the second time around
+    EXPECT_EQ(entity.getComponent<BaseScript>(), &script);
+    EXPECT_EQ(entity.getComponent<BaseScript>(), &script);
+
+    const vroom::Entity& constEntity = entity;
+    EXPECT_EQ(constEntity.getComponent<BaseScript>(), &script);
+}
+
+template <int N>
+class NumberedComponent : public vroom::Component {
+public:
+    int number = N;
+};
+
+template <int N>
+class NumberedScript : public BaseScript {};
+
+template <int... N>
+void addNumberedComponents(vroom::Entity& entity, std::integer_sequence<int, N...>) {
+    (entity.addComponent<NumberedComponent<N>>(), ...);
+}
+
+TEST(EntityComponentTest, LookupBeyondMaskedTypes) {
+    // Enough distinct types that some IDs fall outside the component mask
+    vroom::Entity entity(1, nullptr);
+    addNumberedComponents(entity, std::make_integer_sequence<int, vroom::MaxMaskedComponentTypes + 8>{});
+    auto& script = entity.addComponent<NumberedScript<0>>();
+    ASSERT_GE(vroom::componentTypeId<NumberedScript<0>>(), vroom::MaxMaskedComponentTypes);
+
+    auto* first = entity.getComponent<NumberedComponent<0>>();
+    auto* last = entity.getComponent<NumberedComponent<vroom::MaxMaskedComponentTypes + 7>>();
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(first->number, 0);
+    EXPECT_EQ(last->number, static_cast<int>(vroom::MaxMaskedComponentTypes) + 7);
+    EXPECT_EQ(entity.getComponent<NumberedScript<0>>(), &script);
+    EXPECT_EQ(entity.getComponent<BaseScript>(), &script);
+    EXPECT_EQ(entity.getComponent<NumberedScript<1>>(), nullptr);
+}
+
+TEST(EntityComponentTest, RemoveComponentReindexesLookups) {
+    vroom::Entity entity(1, nullptr);
+    auto& firstPos = entity.addComponent<PositionComponent>(1.0f, 0.0f, 0.0f);
+    auto& vel = entity.addComponent<VelocityComponent>(2.0f, 0.0f, 0.0f);
+    auto& secondPos = entity.addComponent<PositionComponent>(3.0f, 0.0f, 0.0f);
+    EXPECT_EQ(entity.getComponent<PositionComponent>(), &firstPos);
+
+    // The next component of the type takes over, and later components are still found
+    EXPECT_TRUE(entity.removeComponent<PositionComponent>());
+    EXPECT_EQ(entity.getComponent<PositionComponent>(), &secondPos);
+    EXPECT_EQ(entity.getComponent<VelocityComponent>(), &vel);
+
+    EXPECT_TRUE(entity.removeComponent<PositionComponent>());
+    EXPECT_EQ(entity.getComponent<PositionComponent>(), nullptr);
+    EXPECT_FALSE(entity.removeComponent<PositionComponent>());
+    EXPECT_EQ(entity.getComponent<VelocityComponent>(), &vel);
+}
+
+class MoverComponent : public vroom::Component {
+public:
+    void update(float deltaTime) override { distance += deltaTime; }
+    float distance = 0.0f;
+};
+
+class FastMoverComponent : public MoverComponent {};
+
+TEST(EntityComponentTest, OnlyComponentsOverridingUpdateAreUpdated) {
+    static_assert(!vroom::overridesUpdate<PositionComponent>());
+    static_assert(vroom::overridesUpdate<MoverComponent>());
+    static_assert(vroom::overridesUpdate<FastMoverComponent>());
+
+    auto scene = std::make_shared<vroom::Scene>();
+    vroom::Entity& entity = scene->createEntity();
+    entity.addComponent<PositionComponent>(0.0f, 0.0f, 0.0f);
+    auto& mover = entity.addComponent<MoverComponent>();
+    auto& fastMover = entity.addComponent<FastMoverComponent>();
+    scene->update(1.0f);
+    EXPECT_EQ(mover.distance, 1.0f);
+    EXPECT_EQ(fastMover.distance, 1.0f);
+
+    // Removed components drop out of the update list
+    entity.removeComponent<MoverComponent>();
+    scene->update(1.0f);
+    EXPECT_EQ(fastMover.distance, 2.0f);
+}
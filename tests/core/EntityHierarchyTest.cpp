@@ -1,11 +1,7 @@
 #include <gtest/gtest.h>
 #include "vroom/core/Entity.hpp"
 #include "vroom/core/Component.hpp"
-
-// Mock Scene for Entity
-namespace vroom {
-class Scene {};
-}
+#include "vroom/core/Scene.hpp"
 
 class HierarchyTrackerComponent : public vroom::Component {
 public:
@@ -18,23 +14,29 @@ public:
     void update(float dt) override { updateCount++; }
 };
 
-TEST(EntityHierarchyTest, AddRemoveChild) {
-    vroom::Entity parent(1, nullptr);
-    vroom::Entity child(2, nullptr);
+// Parent and child links resolve through the scene, so hierarchies are built from scene entities
+class EntityHierarchyTest : public ::testing::Test {
+protected:
+    std::shared_ptr<vroom::Scene> scene = std::make_shared<vroom::Scene>();
+};
+
+TEST_F(EntityHierarchyTest, AddRemoveChild) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
 
     parent.addChild(&child);
     EXPECT_EQ(child.getParent(), &parent);
     EXPECT_EQ(parent.getChildren().size(), 1);
-    EXPECT_EQ(parent.getChildren()[0], &child);
+    EXPECT_EQ(parent.getChild(0), &child);
 
     parent.removeChild(&child);
     EXPECT_EQ(child.getParent(), nullptr);
     EXPECT_TRUE(parent.getChildren().empty());
 }
 
-TEST(EntityHierarchyTest, SetParent) {
-    vroom::Entity parent(1, nullptr);
-    vroom::Entity child(2, nullptr);
+TEST_F(EntityHierarchyTest, SetParent) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
 
     child.setParent(&parent);
     EXPECT_EQ(child.getParent(), &parent);
@@ -45,9 +47,9 @@ TEST(EntityHierarchyTest, SetParent) {
     EXPECT_TRUE(parent.getChildren().empty());
 }
 
-TEST(EntityHierarchyTest, ActiveStatePropagation) {
-    vroom::Entity parent(1, nullptr);
-    vroom::Entity child(2, nullptr);
+TEST_F(EntityHierarchyTest, ActiveStatePropagation) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
     
     parent.addChild(&child);
     auto& comp = child.addComponent<HierarchyTrackerComponent>();
@@ -69,9 +71,9 @@ TEST(EntityHierarchyTest, ActiveStatePropagation) {
     EXPECT_EQ(comp.enableCount, 2);
 }
 
-TEST(EntityHierarchyTest, ChildLocalState) {
-    vroom::Entity parent(1, nullptr);
-    vroom::Entity child(2, nullptr);
+TEST_F(EntityHierarchyTest, ChildLocalState) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
     
     parent.addChild(&child);
     auto& comp = child.addComponent<HierarchyTrackerComponent>();
@@ -97,10 +99,10 @@ TEST(EntityHierarchyTest, ChildLocalState) {
     EXPECT_EQ(comp.enableCount, 2);
 }
 
-TEST(EntityHierarchyTest, DeepHierarchy) {
-    vroom::Entity root(1, nullptr);
-    vroom::Entity mid(2, nullptr);
-    vroom::Entity leaf(3, nullptr);
+TEST_F(EntityHierarchyTest, DeepHierarchy) {
+    vroom::Entity& root = scene->createEntity();
+    vroom::Entity& mid = scene->createEntity();
+    vroom::Entity& leaf = scene->createEntity();
 
     root.addChild(&mid);
     mid.addChild(&leaf);
@@ -118,36 +120,36 @@ TEST(EntityHierarchyTest, DeepHierarchy) {
     EXPECT_EQ(comp.enableCount, 2);
 }
 
-TEST(EntityHierarchyTest, UpdatePropagation) {
-    vroom::Entity parent(1, nullptr);
-    vroom::Entity child(2, nullptr);
+TEST_F(EntityHierarchyTest, UpdatePropagation) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
     
     parent.addChild(&child);
     auto& pComp = parent.addComponent<HierarchyTrackerComponent>();
     auto& cComp = child.addComponent<HierarchyTrackerComponent>();
 
-    parent.update(0.1f);
+    scene->update(0.1f);
     EXPECT_EQ(pComp.updateCount, 1);
     EXPECT_EQ(cComp.updateCount, 1);
 
     // Disable child
     child.setActive(false);
-    parent.update(0.1f);
+    scene->update(0.1f);
     EXPECT_EQ(pComp.updateCount, 2);
     EXPECT_EQ(cComp.updateCount, 1); // Skipped
 
     // Disable parent
     child.setActive(true);
     parent.setActive(false);
-    parent.update(0.1f);
+    scene->update(0.1f);
     EXPECT_EQ(pComp.updateCount, 2); // Skipped
     EXPECT_EQ(cComp.updateCount, 1); // Skipped
 }
 
-TEST(EntityHierarchyTest, Reparenting) {
-    vroom::Entity parent1(1, nullptr);
-    vroom::Entity parent2(2, nullptr);
-    vroom::Entity child(3, nullptr);
+TEST_F(EntityHierarchyTest, Reparenting) {
+    vroom::Entity& parent1 = scene->createEntity();
+    vroom::Entity& parent2 = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
     auto& comp = child.addComponent<HierarchyTrackerComponent>();
 
     parent1.addChild(&child);
@@ -166,9 +168,33 @@ TEST(EntityHierarchyTest, Reparenting) {
     EXPECT_EQ(parent2.getChildren().size(), 1);
 }
 
-TEST(EntityHierarchyTest, CyclePrevention) {
-    vroom::Entity p(1, nullptr);
-    vroom::Entity c(2, nullptr);
+TEST_F(EntityHierarchyTest, ReparentingSubtreeUpdatesCachedState) {
+    vroom::Entity& inactiveParent = scene->createEntity();
+    vroom::Entity& root = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
+    vroom::Entity& disabledChild = scene->createEntity();
+    auto& comp = child.addComponent<HierarchyTrackerComponent>();
+    root.addChild(&child);
+    root.addChild(&disabledChild);
+    disabledChild.setActive(false);
+    inactiveParent.setActive(false);
+
+    root.setParent(&inactiveParent);
+    EXPECT_FALSE(root.isActive());
+    EXPECT_FALSE(child.isActive());
+    EXPECT_EQ(comp.disableCount, 1);
+
+    root.setParent(nullptr);
+    EXPECT_TRUE(child.isActive());
+    // A child that is inactive itself stays inactive
+    EXPECT_FALSE(disabledChild.isActive());
+    disabledChild.setActive(true);
+    EXPECT_TRUE(disabledChild.isActive());
+}
+
+TEST_F(EntityHierarchyTest, CyclePrevention) {
+    vroom::Entity& p = scene->createEntity();
+    vroom::Entity& c = scene->createEntity();
     
     p.addChild(&c);
     // Try to make p a child of c (cycle)
@@ -182,3 +208,36 @@ TEST(EntityHierarchyTest, CyclePrevention) {
     EXPECT_EQ(p.getParent(), nullptr);
 }
 
+
+TEST_F(EntityHierarchyTest, LinksOutsideTheSceneAreRefused) {
+    vroom::Entity& entity = scene->createEntity();
+    auto other = std::make_shared<vroom::Scene>();
+    vroom::Entity& foreign = other->createEntity();
+    vroom::Entity loose(1, nullptr);
+
+    entity.setParent(&foreign);
+    EXPECT_EQ(entity.getParent(), nullptr);
+    EXPECT_TRUE(foreign.getChildren().empty());
+
+    entity.addChild(&loose);
+    EXPECT_EQ(loose.getParent(), nullptr);
+    EXPECT_TRUE(entity.getChildren().empty());
+}
+
+TEST_F(EntityHierarchyTest, LinksToFreedSlotsDoNotResolve) {
+    vroom::Entity& parent = scene->createEntity();
+    vroom::Entity& child = scene->createEntity();
+    parent.addChild(&child);
+    vroom::EntityHandle childHandle = child.getHandle();
+    EXPECT_EQ(parent.getChildren()[0], childHandle);
+    EXPECT_EQ(child.getParentHandle(), parent.getHandle());
+
+    // The freed child unlinks itself, and its successor in the slot is not taken for it
+    scene->destroyEntity(child);
+    scene->flushDestroyedEntities();
+    vroom::Entity& successor = scene->createEntity();
+    EXPECT_EQ(successor.getHandle().index, childHandle.index);
+    EXPECT_TRUE(parent.getChildren().empty());
+    EXPECT_EQ(successor.getParent(), nullptr);
+    EXPECT_EQ(scene->getEntity(childHandle), nullptr);
+}
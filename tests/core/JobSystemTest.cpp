@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "vroom/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace vroom;
+
+TEST(JobSystemTest, DefaultThreadCount) {
+    JobSystem jobs;
+    EXPECT_GE(jobs.getThreadCount(), 1);
+    EXPECT_FALSE(jobs.isWorkerThread());
+}
+
+TEST(JobSystemTest, SubmitReturnsResult) {
+    JobSystem jobs(2);
+    auto future = jobs.submit([&jobs]() { return jobs.isWorkerThread() ? 42 : 0; });
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(JobSystemTest, CounterWaitsForAllJobs) {
+    JobSystem jobs(4);
+    std::atomic<int> counter{0};
+    JobCounter done;
+    for (int i = 0; i < 1000; ++i) {
+        jobs.run([&counter]() { counter++; }, &done);
+    }
+    jobs.wait(done);
+    EXPECT_TRUE(done.isDone());
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+TEST(JobSystemTest, JobsCanWaitForSubJobs) {
+    // Every worker blocks in wait() on its own sub-jobs; this only finishes if waiting runs jobs
+    JobSystem jobs(2);
+    std::atomic<int> leaves{0};
+    JobCounter outer;
+    for (int i = 0; i < 8; ++i) {
+        jobs.run([&jobs, &leaves]() {
+            JobCounter inner;
+            for (int j = 0; j < 16; ++j) {
+                jobs.run([&leaves]() { leaves++; }, &inner);
+            }
+            jobs.wait(inner);
+        }, &outer);
+    }
+    jobs.wait(outer);
+    EXPECT_EQ(leaves.load(), 8 * 16);
+}
+
+TEST(JobSystemTest, WaitRethrowsJobExceptions) {
+    JobSystem jobs(2);
+    std::atomic<int> finished{0};
+    JobCounter done;
+    jobs.run([]() { throw std::runtime_error("job failed"); }, &done);
+    jobs.run([&finished]() { finished++; }, &done);
+
+    EXPECT_THROW(jobs.wait(done), std::runtime_error);
+    EXPECT_EQ(finished.load(), 1);
+}
+
+TEST(JobSystemTest, ParallelForVisitsEveryIndexOnce) {
+    JobSystem jobs(4);
+    std::vector<std::atomic<int>> visits(10000);
+    jobs.parallelFor(visits.size(), [&visits](size_t i) { visits[i]++; });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(JobSystemTest, IdleWorkersStealQueuedJobs) {
+    JobSystem jobs(4);
+    std::mutex mutex;
+    std::vector<std::thread::id> threads;
+    JobCounter done;
+
+    // All jobs land on one worker's deque; the others can only get them by stealing
+    jobs.run([&]() {
+        for (int i = 0; i < 64; ++i) {
+            jobs.run([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.push_back(std::this_thread::get_id());
+            }, &done);
+        }
+    }, &done);
+    jobs.wait(done);
+
+    std::sort(threads.begin(), threads.end());
+    EXPECT_EQ(threads.size(), 64);
+    EXPECT_GT(std::unique(threads.begin(), threads.end()) - threads.begin(), 1);
+}
+
+TEST(JobSystemTest, DestructorRunsQueuedJobs) {
+    std::atomic<int> counter{0};
+    {
+        JobSystem jobs(1);
+        for (int i = 0; i < 100; ++i) {
+            jobs.run([&counter]() { counter++; });
+        }
+    }
+    EXPECT_EQ(counter.load(), 100);
+}
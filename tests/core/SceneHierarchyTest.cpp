@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "vroom/core/Scene.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace vroom;
+
+class SceneHierarchyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene = std::make_shared<Scene>();
+    }
+
+    // Checks that the hierarchy is in pre-order and that its links match the entities'
+    void expectConsistent() {
+        const SceneHierarchy& hierarchy = scene->getHierarchy();
+        for (size_t position = 0; position < hierarchy.size(); ++position) {
+            Entity& entity = hierarchy.getEntity(position);
+            EXPECT_EQ(hierarchy.find(entity), position);
+
+            uint32_t parent = hierarchy.getParent(position);
+            if (entity.getParent()) {
+                ASSERT_LT(parent, position);
+                EXPECT_EQ(&hierarchy.getEntity(parent), entity.getParent());
+            } else {
+                EXPECT_EQ(parent, SceneHierarchy::NoPosition);
+            }
+
+            // The subtree is exactly the following entities that descend from this one
+            size_t end = position + hierarchy.getSubtreeSize(position);
+            ASSERT_LE(end, hierarchy.size());
+            for (size_t other = position + 1; other < hierarchy.size(); ++other) {
+                bool descends = false;
+                for (Entity* ancestor = hierarchy.getEntity(other).getParent(); ancestor; ancestor = ancestor->getParent()) {
+                    descends |= ancestor == &entity;
+                }
+                EXPECT_EQ(descends, other < end);
+            }
+        }
+    }
+
+    std::shared_ptr<Scene> scene;
+};
+
+TEST_F(SceneHierarchyTest, ReparentingKeepsParentsBeforeChildren) {
+    Entity& a = scene->createEntity();
+    Entity& b = scene->createEntity();
+    Entity& c = scene->createEntity();
+    Entity& d = scene->createEntity();
+    Entity& e = scene->createEntity();
+
+    // Children created after their parents, and before them
+    a.addChild(&d);
+    e.addChild(&a);
+    c.addChild(&b);
+    expectConsistent();
+
+    // Into a subtree, out of it, and across subtrees
+    d.addChild(&c);
+    expectConsistent();
+    c.setParent(nullptr);
+    expectConsistent();
+    b.setParent(&e);
+    expectConsistent();
+    e.setParent(&c);
+    expectConsistent();
+
+    EXPECT_EQ(scene->getRootEntities(), std::vector<Entity*>{&c});
+    EXPECT_EQ(scene->getHierarchy().getSubtreeSize(0), 5);
+}
+
+TEST_F(SceneHierarchyTest, DestroyedSubtreesAreCompactedAtFlush) {
+    Entity& root = scene->createEntity();
+    Entity& child = scene->createEntity();
+    Entity& grandchild = scene->createEntity();
+    Entity& sibling = scene->createEntity();
+    root.addChild(&child);
+    child.addChild(&grandchild);
+    root.addChild(&sibling);
+
+    scene->destroyEntity(child);
+    EXPECT_EQ(scene->getHierarchy().size(), 4);
+    scene->flushDestroyedEntities();
+
+    EXPECT_EQ(scene->getHierarchy().size(), 2);
+    EXPECT_EQ(scene->getHierarchy().getSubtreeSize(0), 2);
+    expectConsistent();
+}
+
+class OrderComponent : public Component {
+public:
+    OrderComponent(std::string& order, char name) : m_order(order), m_name(name) {}
+    void update(float) override { m_order += m_name; }
+
+private:
+    std::string& m_order;
+    char m_name;
+};
+
+class AdoptingComponent : public Component {
+public:
+    explicit AdoptingComponent(Entity& orphan) : m_orphan(orphan) {}
+    void update(float) override { m_orphan.setParent(getEntity()); }
+
+private:
+    Entity& m_orphan;
+};
+
+TEST_F(SceneHierarchyTest, UpdateVisitsParentsBeforeChildren) {
+    std::string order;
+    Entity& child = scene->createEntity();
+    Entity& parent = scene->createEntity();
+    Entity& orphan = scene->createEntity();
+    child.addComponent<OrderComponent>(order, 'c');
+    parent.addComponent<OrderComponent>(order, 'p');
+    orphan.addComponent<OrderComponent>(order, 'o');
+    parent.addChild(&child);
+
+    // Adopted mid-update: the pass order holds for this frame, the hierarchy catches up after it
+    child.addComponent<AdoptingComponent>(orphan);
+    scene->update(0.016f);
+    EXPECT_EQ(order, "pco");
+    EXPECT_EQ(orphan.getParent(), &child);
+    expectConsistent();
+
+    order.clear();
+    scene->update(0.016f);
+    EXPECT_EQ(order, "pco");
+    EXPECT_EQ(scene->getRootEntities(), std::vector<Entity*>{&parent});
+}
+
+TEST_F(SceneHierarchyTest, RebuildKeepsEntitiesRefusedAParentInAnotherScene) {
+    auto other = std::make_shared<Scene>();
+    Entity& foreignParent = other->createEntity();
+    Entity& adopted = scene->createEntity();
+    adopted.setParent(&foreignParent);
+    EXPECT_EQ(adopted.getParent(), nullptr);
+
+    // Reparenting mid-update makes the scene rebuild its hierarchy after the loop
+    Entity& parent = scene->createEntity();
+    Entity& orphan = scene->createEntity();
+    parent.addComponent<AdoptingComponent>(orphan);
+    scene->update(0.016f);
+
+    const SceneHierarchy& hierarchy = scene->getHierarchy();
+    ASSERT_EQ(hierarchy.size(), 3u);
+    uint32_t position = hierarchy.find(adopted);
+    ASSERT_NE(position, SceneHierarchy::NoPosition);
+    EXPECT_EQ(hierarchy.getParent(position), SceneHierarchy::NoPosition);
+    EXPECT_EQ(hierarchy.getParent(hierarchy.find(orphan)), hierarchy.find(parent));
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include "vroom/core/SceneSerializer.hpp"
+#include "vroom/core/SceneFormat.hpp"
+#include "vroom/core/SceneHierarchy.hpp"
+#include "vroom/core/SceneManager.hpp"
+#include "vroom/core/Transform.hpp"
+
+#include <cstring>
+#include <filesystem>
+
+using namespace vroom;
+
+namespace {
+
+class Health : public Component {
+public:
+    int value = 100;
+};
+
+struct HealthData {
+    int32_t value;
+};
+
+void to_json(nlohmann::json& json, const HealthData& data) {
+    json = {{"value", data.value}};
+}
+
+void from_json(const nlohmann::json& json, HealthData& data) {
+    data.value = json.at("value").get<int32_t>();
+}
+
+void registerHealth(ComponentRegistry& registry) {
+    registry.registerType<Health, HealthData>(
+        "Health",
+        [](const Health& health) { return HealthData{health.value}; },
+        [](Health& health, const HealthData& data) { health.value = data.value; });
+}
+
+} // namespace
+
+class SceneSerializerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        registry.registerBuiltins();
+        registerHealth(registry);
+
+        // root -> (child -> grandchild), loose; child inactive
+        source = std::make_shared<Scene>();
+        Entity& root = source->createEntity();
+        Entity& child = source->createEntity();
+        Entity& loose = source->createEntity();
+        Entity& grandchild = source->createEntity();
+        root.addChild(&child);
+        child.addChild(&grandchild);
+        child.setActive(false);
+
+        auto& rootTransform = root.addComponent<Transform>();
+        rootTransform.setLocalPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+        rootTransform.setLocalRotation(glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+        grandchild.addComponent<Transform>().setLocalScale(glm::vec3(2.0f));
+        grandchild.addComponent<Health>().value = 42;
+        loose.addComponent<Health>().value = 7;
+
+        // Destroyed but not yet flushed, so still in the hierarchy
+        Entity& doomed = source->createEntity();
+        doomed.addComponent<Health>();
+        source->destroyEntity(doomed);
+    }
+
+    // Checks target holds what SetUp() built, in hierarchy order
+    static void expectLoaded(Scene& target, bool withHealth = true) {
+        const SceneHierarchy& hierarchy = target.getHierarchy();
+        ASSERT_EQ(hierarchy.size(), 4u);
+        Entity& root = hierarchy.getEntity(0);
+        Entity& child = hierarchy.getEntity(1);
+        Entity& grandchild = hierarchy.getEntity(2);
+        Entity& loose = hierarchy.getEntity(3);
+
+        EXPECT_EQ(root.getParent(), nullptr);
+        EXPECT_EQ(child.getParent(), &root);
+        EXPECT_EQ(grandchild.getParent(), &child);
+        EXPECT_EQ(loose.getParent(), nullptr);
+        EXPECT_TRUE(root.isActive());
+        EXPECT_FALSE(child.isActiveSelf());
+        EXPECT_TRUE(grandchild.isActiveSelf());
+        EXPECT_FALSE(grandchild.isActive());
+
+        Transform* rootTransform = root.getComponent<Transform>();
+        ASSERT_NE(rootTransform, nullptr);
+        EXPECT_EQ(rootTransform->getLocalPosition(), glm::vec3(1.0f, 2.0f, 3.0f));
+        EXPECT_EQ(rootTransform->getLocalRotation(), glm::angleAxis(0.5f, glm::vec3(0.0f, 1.0f, 0.0f)));
+        ASSERT_NE(grandchild.getComponent<Transform>(), nullptr);
+        EXPECT_EQ(grandchild.getComponent<Transform>()->getLocalScale(), glm::vec3(2.0f));
+        EXPECT_EQ(child.getComponent<Transform>(), nullptr);
+
+        if (withHealth) {
+            ASSERT_NE(grandchild.getComponent<Health>(), nullptr);
+            EXPECT_EQ(grandchild.getComponent<Health>()->value, 42);
+            ASSERT_NE(loose.getComponent<Health>(), nullptr);
+            EXPECT_EQ(loose.getComponent<Health>()->value, 7);
+        } else {
+            EXPECT_EQ(grandchild.getComponent<Health>(), nullptr);
+            EXPECT_EQ(loose.getComponent<Health>(), nullptr);
+        }
+    }
+
+    ComponentRegistry registry;
+    std::shared_ptr<Scene> source;
+};
+
+TEST_F(SceneSerializerTest, BinaryRoundTripKeepsHierarchyActiveStateAndComponents) {
+    SceneSerializer serializer(registry);
+    std::vector<char> data = serializer.saveBinary(*source);
+
+    auto target = std::make_shared<Scene>();
+    ASSERT_TRUE(serializer.loadBinary(*target, data.data(), data.size()));
+    expectLoaded(*target);
+
+    // Saving the loaded scene gives the same bytes back
+    EXPECT_EQ(serializer.saveBinary(*target), data);
+}
+
+TEST_F(SceneSerializerTest, JsonRoundTripKeepsHierarchyActiveStateAndComponents) {
+    SceneSerializer serializer(registry);
+    nlohmann::json json = serializer.saveJson(*source);
+    EXPECT_EQ(json["entities"][2]["components"][1]["type"], "Health");
+    EXPECT_EQ(json["entities"][2]["components"][1]["data"]["value"], 42);
+
+    auto target = std::make_shared<Scene>();
+    ASSERT_TRUE(serializer.loadJson(*target, nlohmann::json::parse(json.dump())));
+    expectLoaded(*target);
+    EXPECT_EQ(serializer.saveJson(*target), json);
+}
+
+TEST_F(SceneSerializerTest, UnregisteredTypesAreSkipped) {
+    std::vector<char> data = SceneSerializer(registry).saveBinary(*source);
+    nlohmann::json json = SceneSerializer(registry).saveJson(*source);
+
+    ComponentRegistry builtins;
+    builtins.registerBuiltins();
+    SceneSerializer serializer(builtins);
+
+    auto fromBinary = std::make_shared<Scene>();
+    ASSERT_TRUE(serializer.loadBinary(*fromBinary, data.data(), data.size()));
+    expectLoaded(*fromBinary, false);
+
+    auto fromJson = std::make_shared<Scene>();
+    ASSERT_TRUE(serializer.loadJson(*fromJson, json));
+    expectLoaded(*fromJson, false);
+}
+
+TEST_F(SceneSerializerTest, RejectedDataLeavesTheSceneUntouched) {
+    SceneSerializer serializer(registry);
+    std::vector<char> data = serializer.saveBinary(*source);
+    auto target = std::make_shared<Scene>();
+
+    EXPECT_FALSE(serializer.loadBinary(*target, data.data(), data.size() - 1));
+
+    std::vector<char> newer = data;
+    uint32_t version = SCENE_VERSION_1 + 1;
+    std::memcpy(newer.data() + offsetof(SceneFileHeader, version), &version, sizeof(version));
+    EXPECT_FALSE(serializer.loadBinary(*target, newer.data(), newer.size()));
+
+    std::vector<char> badMagic = data;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(serializer.loadBinary(*target, badMagic.data(), badMagic.size()));
+
+    nlohmann::json json = serializer.saveJson(*source);
+    json["entities"][0]["parent"] = 3; // After the entity itself
+    EXPECT_FALSE(serializer.loadJson(*target, json));
+
+    EXPECT_EQ(target->getEntityCount(), 0u);
+}
+
+TEST_F(SceneSerializerTest, ShaderCacheDataIsNotAScene) {
+    SceneSerializer serializer(registry);
+    auto target = std::make_shared<Scene>();
+
+    // Header of a shader cache entry: magic, version 1, then size and checksum
+    std::vector<char> cacheEntry(24 + 64, 0);
+    std::memcpy(cacheEntry.data(), "VRSC", 4);
+    uint32_t cacheVersion = 1;
+    std::memcpy(cacheEntry.data() + 4, &cacheVersion, sizeof(cacheVersion));
+    EXPECT_FALSE(serializer.loadBinary(*target, cacheEntry.data(), cacheEntry.size()));
+
+    // Even a well-formed scene body is rejected behind the shader cache's magic
+    std::vector<char> data = serializer.saveBinary(*source);
+    std::memcpy(data.data(), "VRSC", 4);
+    EXPECT_FALSE(serializer.loadBinary(*target, data.data(), data.size()));
+    EXPECT_EQ(target->getEntityCount(), 0u);
+}
+
+TEST_F(SceneSerializerTest, SceneManagerLoadsSavedFiles) {
+    SceneManager manager;
+    registerHealth(manager.getComponentRegistry());
+    auto directory = std::filesystem::temp_directory_path();
+
+    for (const char* name : {"vroom_serializer_test.vrscene", "vroom_serializer_test.json"}) {
+        std::string path = (directory / name).string();
+        ASSERT_TRUE(manager.saveScene(*source, path));
+        manager.loadScene(path);
+        std::filesystem::remove(path);
+
+        ASSERT_NE(manager.getActiveScene(), nullptr);
+        expectLoaded(*manager.getActiveScene());
+    }
+}
@@ -3,6 +3,9 @@
 #include "vroom/core/Scene.hpp"
 #include "vroom/core/Component.hpp"
 
+#include <algorithm>
+#include <string>
+
 using namespace vroom;
 
 class SceneTest : public ::testing::Test {
@@ -145,3 +148,377 @@ TEST_F(SceneTest, GetRootEntitiesOnlyReturnsRoots) {
     EXPECT_EQ(roots.size(), 1);
     EXPECT_EQ(roots[0], &parent);
 }
+
+struct StoredComponent : public Component {
+    explicit StoredComponent(int value) : value(value) {}
+    int value;
+};
+
+TEST_F(SceneTest, ComponentsOfOneTypeAreStoredContiguously) {
+    std::vector<StoredComponent*> components;
+    for (int i = 0; i < 64; ++i) {
+        components.push_back(&scene->createEntity().addComponent<StoredComponent>(i));
+    }
+
+    for (size_t i = 1; i < components.size(); ++i) {
+        EXPECT_EQ(components[i], components[i - 1] + 1);
+    }
+
+    int expected = 0;
+    scene->forEachComponent<StoredComponent>([&expected](StoredComponent& component) {
+        EXPECT_EQ(component.value, expected++);
+    });
+    EXPECT_EQ(expected, 64);
+}
+
+TEST_F(SceneTest, DestroyedComponentSlotsAreReused) {
+    Entity& first = scene->createEntity();
+    Entity& second = scene->createEntity();
+    auto* freed = &first.addComponent<StoredComponent>(1);
+    second.addComponent<StoredComponent>(2);
+
+    scene->destroyEntity(first);
+    scene->flushDestroyedEntities();
+    EXPECT_EQ(scene->getComponentStorage().getPool<StoredComponent>().size(), 1);
+
+    auto& reused = scene->createEntity().addComponent<StoredComponent>(3);
+    EXPECT_EQ(&reused, freed);
+
+    int visited = 0;
+    scene->forEachComponent<StoredComponent>([&visited](StoredComponent&) { ++visited; });
+    EXPECT_EQ(visited, 2);
+}
+
+struct QueriedComponent : public Component {
+    int hits = 0;
+};
+
+TEST_F(SceneTest, QueryVisitsOnlyEntitiesWithAllComponents) {
+    Entity& both = scene->createEntity();
+    both.addComponent<StoredComponent>(1);
+    both.addComponent<QueriedComponent>();
+    scene->createEntity().addComponent<StoredComponent>(2);
+    scene->createEntity().addComponent<QueriedComponent>();
+
+    auto query = scene->query<StoredComponent, QueriedComponent>();
+    EXPECT_EQ(query.size(), 1);
+
+    query.each([&both](Entity& entity, StoredComponent& stored, QueriedComponent& queried) {
+        EXPECT_EQ(&entity, &both);
+        EXPECT_EQ(stored.value, 1);
+        ++queried.hits;
+    });
+    EXPECT_EQ(both.getComponent<QueriedComponent>()->hits, 1);
+}
+
+TEST_F(SceneTest, QueryTracksAddedComponentsAndDestroyedEntities) {
+    auto query = scene->query<StoredComponent, QueriedComponent>();
+    EXPECT_TRUE(query.empty());
+
+    Entity& first = scene->createEntity();
+    first.addComponent<StoredComponent>(1);
+    EXPECT_TRUE(query.empty());
+    first.addComponent<QueriedComponent>();
+    EXPECT_EQ(query.size(), 1);
+
+    Entity& second = scene->createEntity();
+    second.addComponent<QueriedComponent>();
+    second.addComponent<StoredComponent>(2);
+    EXPECT_EQ(query.size(), 2);
+
+    scene->destroyEntity(first);
+    int sum = 0;
+    scene->each<StoredComponent, QueriedComponent>([&sum](StoredComponent& stored, QueriedComponent&) {
+        sum += stored.value;
+    });
+    EXPECT_EQ(sum, 2);
+
+    scene->clear();
+    EXPECT_TRUE(query.empty());
+}
+
+TEST_F(SceneTest, QueryVisitsEachMatchOnceWhenComponentsAreRemovedWhileIterating) {
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 4; ++i) {
+        Entity& entity = scene->createEntity();
+        entity.addComponent<StoredComponent>(i);
+        entity.addComponent<QueriedComponent>();
+        entities.push_back(&entity);
+    }
+
+    // The first visit removes its own match and the one of an entity not visited yet,
+    // which would otherwise swap the last matches into visited places
+    auto query = scene->query<StoredComponent, QueriedComponent>();
+    std::vector<int> visited;
+    Entity* unvisited = nullptr;
+    query.each([&](Entity& entity, StoredComponent& stored, QueriedComponent&) {
+        visited.push_back(stored.value);
+        if (visited.size() == 1) {
+            unvisited = entity.getComponent<StoredComponent>()->value == 0 ? entities[1] : entities[0];
+            entity.removeComponent<QueriedComponent>();
+            unvisited->removeComponent<QueriedComponent>();
+        }
+    });
+    EXPECT_EQ(visited.size(), 3);
+    std::sort(visited.begin(), visited.end());
+    EXPECT_EQ(std::adjacent_find(visited.begin(), visited.end()), visited.end());
+    EXPECT_EQ(std::find(visited.begin(), visited.end(), unvisited->getComponent<StoredComponent>()->value), visited.end());
+
+    // Removed matches are gone once the iteration is done
+    EXPECT_EQ(query.size(), 2);
+    int count = 0;
+    query.each([&count](StoredComponent&, QueriedComponent&) { ++count; });
+    EXPECT_EQ(count, 2);
+}
+
+TEST_F(SceneTest, HandlesResolveToTheirEntity) {
+    Entity& entity = scene->createEntity();
+    EntityHandle handle = entity.getHandle();
+
+    EXPECT_FALSE(handle.isNull());
+    EXPECT_EQ(scene->getEntity(handle), &entity);
+    EXPECT_EQ(EntityHandle::fromId(entity.getId()), handle);
+    EXPECT_EQ(scene->getEntity(EntityHandle{}), nullptr);
+    EXPECT_EQ(scene->getEntityCount(), 1);
+}
+
+TEST_F(SceneTest, StaleHandlesAreDetectedAfterSlotReuse) {
+    Entity& first = scene->createEntity();
+    EntityHandle stale = first.getHandle();
+    scene->destroyEntity(stale);
+    EXPECT_FALSE(scene->isValid(stale));
+    EXPECT_EQ(scene->getEntityCount(), 0);
+    scene->flushDestroyedEntities();
+
+    // The freed slot is recycled under a new generation
+    Entity& second = scene->createEntity();
+    EntityHandle fresh = second.getHandle();
+    EXPECT_EQ(fresh.index, stale.index);
+    EXPECT_NE(fresh.generation, stale.generation);
+    EXPECT_NE(second.getId(), stale.toId());
+    EXPECT_EQ(scene->getEntity(stale), nullptr);
+    EXPECT_EQ(scene->getEntity(fresh), &second);
+
+    // Destroying through the stale handle must not touch the new entity
+    scene->destroyEntity(stale);
+    EXPECT_TRUE(scene->isValid(fresh));
+}
+
+TEST_F(SceneTest, ClearInvalidatesHandles) {
+    EntityHandle handle = scene->createEntity().getHandle();
+    scene->clear();
+    EXPECT_FALSE(scene->isValid(handle));
+    EXPECT_NE(scene->createEntity().getHandle(), handle);
+}
+
+class SelfDestroyingComponent : public Component {
+public:
+    SelfDestroyingComponent(Scene& scene, int& destroyCount) : m_scene(scene), m_destroyCount(destroyCount) {}
+
+    void update(float) override {
+        m_scene.destroyEntity(*getEntity());
+        // The handle stops resolving, but the entity stays in place until the update is over
+        EXPECT_FALSE(m_scene.isValid(getEntity()->getHandle()));
+        EXPECT_TRUE(getEntity()->isDestroyed());
+        EXPECT_EQ(m_destroyCount, 0);
+    }
+
+    void onDestroy() override { ++m_destroyCount; }
+
+private:
+    Scene& m_scene;
+    int& m_destroyCount;
+};
+
+TEST_F(SceneTest, DestroyDuringUpdateIsFlushedAfterUpdate) {
+    int destroyCount = 0;
+    Entity& entity = scene->createEntity();
+    entity.addComponent<SelfDestroyingComponent>(*scene, destroyCount);
+    EntityHandle handle = entity.getHandle();
+
+    scene->update(0.016f);
+    EXPECT_EQ(destroyCount, 1);
+    EXPECT_FALSE(scene->isValid(handle));
+    EXPECT_EQ(scene->getEntityCount(), 0);
+}
+
+class DestroyOrderComponent : public Component {
+public:
+    DestroyOrderComponent(std::vector<int>& order, int id) : m_order(order), m_id(id) {}
+    void onDestroy() override { m_order.push_back(m_id); }
+
+private:
+    std::vector<int>& m_order;
+    int m_id;
+};
+
+TEST_F(SceneTest, DestroyedSubtreeIsRemovedAtFlush) {
+    std::vector<int> order;
+    Entity& root = scene->createEntity();
+    Entity& child = scene->createEntity();
+    Entity& grandchild = scene->createEntity();
+    Entity& survivor = scene->createEntity();
+    root.addComponent<DestroyOrderComponent>(order, 0);
+    child.addComponent<DestroyOrderComponent>(order, 1);
+    grandchild.addComponent<DestroyOrderComponent>(order, 2);
+    survivor.addComponent<DestroyOrderComponent>(order, 3);
+    root.addChild(&child);
+    child.addChild(&grandchild);
+    survivor.addChild(&root);
+    auto query = scene->query<DestroyOrderComponent>();
+
+    scene->destroyEntity(root);
+    EXPECT_TRUE(order.empty());
+    EXPECT_TRUE(child.isDestroyed());
+    EXPECT_TRUE(grandchild.isDestroyed());
+    EXPECT_EQ(scene->getEntityCount(), 1);
+    EXPECT_EQ(query.size(), 4);
+
+    scene->flushDestroyedEntities();
+    EXPECT_EQ(order, (std::vector<int>{2, 1, 0}));
+    EXPECT_TRUE(survivor.getChildren().empty());
+    EXPECT_EQ(query.size(), 1);
+
+    // The survivor reports to order, which goes away before the fixture's scene
+    scene->clear();
+}
+
+class EnableCountComponent : public Component {
+public:
+    explicit EnableCountComponent(int& count) : m_count(count) {}
+    void onEnable() override { ++m_count; }
+
+private:
+    int& m_count;
+};
+
+TEST_F(SceneTest, FlushFreesDescendantsFirstAcrossDestroyCalls) {
+    int enables = 0;
+    std::vector<int> order;
+    Entity& parent = scene->createEntity();
+    Entity& child = scene->createEntity();
+    parent.addChild(&child);
+    parent.setActive(false);
+    parent.addComponent<DestroyOrderComponent>(order, 0);
+    child.addComponent<DestroyOrderComponent>(order, 1);
+    child.addComponent<EnableCountComponent>(enables);
+
+    // Marked child first, so marking order alone would free the parent before it
+    scene->destroyEntity(child);
+    scene->destroyEntity(parent);
+    scene->flushDestroyedEntities();
+
+    EXPECT_EQ(order, (std::vector<int>{1, 0}));
+    EXPECT_EQ(enables, 0);
+    EXPECT_EQ(scene->getEntityCount(), 0);
+}
+
+class UpdateCountComponent : public Component {
+public:
+    explicit UpdateCountComponent(int& updates) : m_updates(updates) {}
+    void update(float) override { ++m_updates; }
+
+private:
+    int& m_updates;
+};
+
+class SpawningComponent : public Component {
+public:
+    SpawningComponent(Scene& scene, int& spawnedUpdates) : m_scene(scene), m_spawnedUpdates(spawnedUpdates) {}
+
+    void update(float) override {
+        if (!m_spawned) {
+            m_spawned = &m_scene.createEntity();
+            m_spawned->addComponent<UpdateCountComponent>(m_spawnedUpdates);
+        }
+    }
+
+    Entity* m_spawned = nullptr;
+
+private:
+    Scene& m_scene;
+    int& m_spawnedUpdates;
+};
+
+TEST_F(SceneTest, EntitiesCreatedDuringUpdateWaitForNextFrame) {
+    // Leave a free slot in front of the spawner, so the new entity lands before it in slot order
+    scene->destroyEntity(scene->createEntity());
+    scene->flushDestroyedEntities();
+
+    int spawnedUpdates = 0;
+    Entity& spawner = scene->createEntity();
+    auto& spawning = spawner.addComponent<SpawningComponent>(*scene, spawnedUpdates);
+
+    scene->update(0.016f);
+    ASSERT_NE(spawning.m_spawned, nullptr);
+    EXPECT_EQ(spawnedUpdates, 0);
+    EXPECT_EQ(scene->getEntityCount(), 2);
+
+    scene->update(0.016f);
+    EXPECT_EQ(spawnedUpdates, 1);
+}
+
+class LifecycleLogComponent : public Component {
+public:
+    LifecycleLogComponent(std::string& log, char name) : m_log(log), m_name(name) {}
+    void start() override { m_log += 's'; m_log += m_name; }
+    void update(float) override { m_log += 'u'; m_log += m_name; }
+
+private:
+    std::string& m_log;
+    char m_name;
+};
+
+TEST_F(SceneTest, ComponentsStartInOneBatchBeforeUpdates) {
+    std::string log;
+    Entity& first = scene->createEntity();
+    Entity& second = scene->createEntity();
+    first.addComponent<LifecycleLogComponent>(log, 'a');
+    second.addComponent<LifecycleLogComponent>(log, 'b');
+    auto& disabled = second.addComponent<LifecycleLogComponent>(log, 'c');
+    disabled.setEnabled(false);
+
+    scene->update(0.016f);
+    EXPECT_EQ(log, "sasbuaub");
+
+    // Enabled mid-frame: it is neither started nor updated until the next frame's start pass
+    log.clear();
+    disabled.setEnabled(true);
+    scene->update(0.016f);
+    EXPECT_EQ(log, "scuaubuc");
+
+    // Removed before it ever started
+    log.clear();
+    Entity& third = scene->createEntity();
+    third.addComponent<LifecycleLogComponent>(log, 'd');
+    third.removeComponent<LifecycleLogComponent>();
+    scene->update(0.016f);
+    EXPECT_EQ(log, "uaubuc");
+}
+
+TEST_F(SceneTest, ComponentsStartOnceActivatedAndUpdateOnlyWhileEnabled) {
+    std::string log;
+    Entity& parent = scene->createEntity();
+    Entity& child = scene->createEntity();
+    child.setParent(&parent);
+    parent.setActive(false);
+    auto& component = child.addComponent<LifecycleLogComponent>(log, 'a');
+
+    scene->update(0.016f);
+    scene->update(0.016f);
+    EXPECT_EQ(log, "");
+
+    // Activating the parent queues the start
+    parent.setActive(true);
+    scene->update(0.016f);
+    EXPECT_EQ(log, "saua");
+
+    // Disabling takes it off the update list, enabling puts it back without a second start
+    log.clear();
+    component.setEnabled(false);
+    scene->update(0.016f);
+    EXPECT_EQ(log, "");
+    component.setEnabled(true);
+    scene->update(0.016f);
+    EXPECT_EQ(log, "ua");
+}
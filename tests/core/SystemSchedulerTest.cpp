@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "vroom/core/Scene.hpp"
+#include "vroom/core/JobSystem.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace vroom;
+
+struct PositionData : public Component {};
+struct VelocityData : public Component {};
+struct HealthData : public Component {};
+
+// Records the order systems ran in
+struct RunLog {
+    std::mutex mutex;
+    std::string order;
+
+    void add(char name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order += name;
+    }
+};
+
+class LoggingSystem : public System {
+public:
+    LoggingSystem(RunLog& log, char name) : m_log(log), m_name(name) {}
+
+    void update(Scene&, float) override {
+        // Give a wrongly scheduled successor the chance to overtake
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        m_log.add(m_name);
+    }
+
+protected:
+    RunLog& m_log;
+    char m_name;
+};
+
+class MovementSystem : public LoggingSystem {
+public:
+    MovementSystem(RunLog& log, char name) : LoggingSystem(log, name) {
+        reads<VelocityData>();
+        writes<PositionData>();
+    }
+};
+
+class PositionReaderSystem : public LoggingSystem {
+public:
+    PositionReaderSystem(RunLog& log, char name) : LoggingSystem(log, name) {
+        reads<PositionData>();
+    }
+};
+
+TEST(SystemSchedulerTest, AccessConflicts) {
+    SystemAccess writer{{}, {componentTypeId<PositionData>()}};
+    SystemAccess reader{{componentTypeId<PositionData>()}, {}};
+    SystemAccess otherReader{{componentTypeId<PositionData>()}, {componentTypeId<HealthData>()}};
+
+    EXPECT_TRUE(writer.conflictsWith(reader));
+    EXPECT_TRUE(reader.conflictsWith(writer));
+    EXPECT_TRUE(writer.conflictsWith(writer));
+    EXPECT_FALSE(reader.conflictsWith(otherReader));
+}
+
+TEST(SystemSchedulerTest, ConflictingSystemsRunInRegistrationOrder) {
+    auto scene = std::make_shared<Scene>();
+    JobSystem jobs(4);
+    RunLog log;
+
+    SystemScheduler scheduler;
+    scheduler.addSystem<MovementSystem>(log, 'a');
+    scheduler.addSystem<PositionReaderSystem>(log, 'b');
+    scheduler.addSystem<MovementSystem>(log, 'c');
+
+    scheduler.run(*scene, 0.016f, &jobs);
+    EXPECT_EQ(log.order, "abc");
+}
+
+class RendezvousSystem : public System {
+public:
+    RendezvousSystem(std::atomic<int>& arrived, bool& metOther) : m_arrived(arrived), m_metOther(metOther) {}
+
+    void update(Scene&, float) override {
+        m_arrived++;
+        // Only succeeds if the other system runs at the same time
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (m_arrived.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        m_metOther = m_arrived.load() >= 2;
+    }
+
+private:
+    std::atomic<int>& m_arrived;
+    bool& m_metOther;
+};
+
+class PositionRendezvousSystem : public RendezvousSystem {
+public:
+    PositionRendezvousSystem(std::atomic<int>& arrived, bool& metOther) : RendezvousSystem(arrived, metOther) {
+        reads<VelocityData>();
+        writes<PositionData>();
+    }
+};
+
+class HealthRendezvousSystem : public RendezvousSystem {
+public:
+    HealthRendezvousSystem(std::atomic<int>& arrived, bool& metOther) : RendezvousSystem(arrived, metOther) {
+        reads<VelocityData>();
+        writes<HealthData>();
+    }
+};
+
+TEST(SystemSchedulerTest, IndependentSystemsRunConcurrently) {
+    auto scene = std::make_shared<Scene>();
+    JobSystem jobs(2);
+    std::atomic<int> arrived{0};
+    bool firstMet = false;
+    bool secondMet = false;
+
+    SystemScheduler scheduler;
+    scheduler.addSystem<PositionRendezvousSystem>(arrived, firstMet);
+    scheduler.addSystem<HealthRendezvousSystem>(arrived, secondMet);
+    scheduler.run(*scene, 0.016f, &jobs);
+
+    EXPECT_TRUE(firstMet);
+    EXPECT_TRUE(secondMet);
+}
+
+class ThrowingSystem : public System {
+public:
+    void update(Scene&, float) override { throw std::runtime_error("system failed"); }
+};
+
+TEST(SystemSchedulerTest, ExceptionsAreRethrownAfterAllSystemsRan) {
+    auto scene = std::make_shared<Scene>();
+    JobSystem jobs(2);
+    RunLog log;
+
+    SystemScheduler scheduler;
+    scheduler.addSystem<ThrowingSystem>();
+    scheduler.addSystem<PositionReaderSystem>(log, 'a');
+
+    EXPECT_THROW(scheduler.run(*scene, 0.016f, &jobs), std::runtime_error);
+    EXPECT_EQ(log.order, "a");
+}
+
+TEST(SystemSchedulerTest, SceneRunsSystemsWithoutSceneManager) {
+    auto scene = std::make_shared<Scene>();
+    RunLog log;
+    scene->addSystem<MovementSystem>(log, 'a');
+    scene->addSystem<PositionReaderSystem>(log, 'b');
+
+    scene->update(0.016f);
+    EXPECT_EQ(log.order, "ab");
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include "vroom/core/Scene.hpp"
+#include "vroom/core/Transform.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace vroom;
+
+class TransformTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scene = std::make_shared<Scene>();
+    }
+
+    static void expectNear(const glm::mat4& actual, const glm::mat4& expected) {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                EXPECT_NEAR(actual[column][row], expected[column][row], 1e-5f) << "column " << column << ", row " << row;
+            }
+        }
+    }
+
+    std::shared_ptr<Scene> scene;
+};
+
+TEST_F(TransformTest, LocalMatrixIsTranslationRotationScale) {
+    Entity& entity = scene->createEntity();
+    auto& transform = entity.addComponent<Transform>();
+    glm::quat rotation = glm::angleAxis(0.5f, glm::vec3(0.0f, 0.0f, 1.0f));
+    transform.setLocalPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    transform.setLocalRotation(rotation);
+    transform.setLocalScale(glm::vec3(2.0f, 3.0f, 4.0f));
+
+    glm::mat4 expected = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 2.0f, 3.0f)) * glm::mat4_cast(rotation);
+    expected = glm::scale(expected, glm::vec3(2.0f, 3.0f, 4.0f));
+    expectNear(transform.getLocalMatrix(), expected);
+}
+
+TEST_F(TransformTest, WorldMatricesComposeDownTheHierarchy) {
+    Entity& root = scene->createEntity();
+    Entity& group = scene->createEntity(); // No transform of its own
+    Entity& leaf = scene->createEntity();
+    root.addChild(&group);
+    group.addChild(&leaf);
+    auto& rootTransform = root.addComponent<Transform>();
+    auto& leafTransform = leaf.addComponent<Transform>();
+
+    rootTransform.setLocalPosition(glm::vec3(10.0f, 0.0f, 0.0f));
+    rootTransform.setLocalRotation(glm::angleAxis(1.0f, glm::vec3(0.0f, 1.0f, 0.0f)));
+    rootTransform.setLocalScale(glm::vec3(2.0f));
+    leafTransform.setLocalPosition(glm::vec3(0.0f, 1.0f, 5.0f));
+    scene->update(0.016f);
+
+    expectNear(rootTransform.getWorldMatrix(), rootTransform.getLocalMatrix());
+    expectNear(leafTransform.getWorldMatrix(), rootTransform.getLocalMatrix() * leafTransform.getLocalMatrix());
+
+    // Moving the leaf under a root without transforms leaves it at its local placement
+    Entity& other = scene->createEntity();
+    leaf.setParent(&other);
+    scene->updateTransforms();
+    expectNear(leafTransform.getWorldMatrix(), leafTransform.getLocalMatrix());
+    EXPECT_NEAR(leafTransform.getWorldPosition().z, 5.0f, 1e-5f);
+}
+
+TEST_F(TransformTest, OnlyChangedSubtreesAreRecomputed) {
+    Entity& rootA = scene->createEntity();
+    Entity& rootB = scene->createEntity();
+    rootA.addComponent<Transform>();
+    auto& rootBTransform = rootB.addComponent<Transform>();
+    Transform* leafA = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        Entity& childA = scene->createEntity();
+        Entity& childB = scene->createEntity();
+        rootA.addChild(&childA);
+        rootB.addChild(&childB);
+        leafA = &childA.addComponent<Transform>();
+        childB.addComponent<Transform>();
+    }
+    EXPECT_EQ(scene->getTransforms().propagate(*scene), 8);
+    EXPECT_EQ(scene->getTransforms().propagate(*scene), 0);
+
+    leafA->setLocalPosition(glm::vec3(1.0f));
+    leafA->setLocalScale(glm::vec3(2.0f));
+    EXPECT_EQ(scene->getTransforms().propagate(*scene), 1);
+
+    // A dirty child inside a dirty subtree is only computed once
+    leafA->setLocalPosition(glm::vec3(3.0f));
+    rootBTransform.setLocalPosition(glm::vec3(1.0f));
+    rootB.getChild(0)->getComponent<Transform>()->setLocalPosition(glm::vec3(2.0f));
+    EXPECT_EQ(scene->getTransforms().propagate(*scene), 5);
+}
+
+TEST_F(TransformTest, PropagationFollowsAddedAndRemovedTransforms) {
+    Entity& root = scene->createEntity();
+    Entity& middle = scene->createEntity();
+    Entity& leaf = scene->createEntity();
+    root.addChild(&middle);
+    middle.addChild(&leaf);
+    root.addComponent<Transform>().setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    middle.addComponent<Transform>().setLocalPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+    auto& leafTransform = leaf.addComponent<Transform>();
+    scene->updateTransforms();
+    EXPECT_NEAR(leafTransform.getWorldPosition().y, 2.0f, 1e-5f);
+
+    // Without its transform, the middle entity passes the root's through
+    middle.removeComponent<Transform>();
+    scene->updateTransforms();
+    EXPECT_NEAR(leafTransform.getWorldPosition().x, 1.0f, 1e-5f);
+    EXPECT_NEAR(leafTransform.getWorldPosition().y, 0.0f, 1e-5f);
+
+    // A reused slot does not inherit the transform of the entity that held it
+    scene->destroyEntity(middle);
+    scene->flushDestroyedEntities();
+    Entity& reused = scene->createEntity();
+    EXPECT_EQ(scene->getTransforms().findBySlot(reused.getHandle().index), TransformStorage::InvalidIndex);
+    root.addChild(&reused);
+    auto& reusedTransform = reused.addComponent<Transform>();
+    reusedTransform.setLocalPosition(glm::vec3(0.0f, 0.0f, 3.0f));
+    scene->updateTransforms();
+    EXPECT_NEAR(reusedTransform.getWorldPosition().x, 1.0f, 1e-5f);
+    EXPECT_NEAR(reusedTransform.getWorldPosition().z, 3.0f, 1e-5f);
+}
+
+TEST_F(TransformTest, TransformWithoutSceneUsesLocalMatrix) {
+    Entity entity(1, nullptr);
+    auto& transform = entity.addComponent<Transform>();
+    transform.setLocalPosition(glm::vec3(4.0f, 5.0f, 6.0f));
+    EXPECT_NEAR(transform.getWorldPosition().y, 5.0f, 1e-6f);
+}
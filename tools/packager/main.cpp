@@ -3,58 +3,73 @@
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <algorithm>
 #include <cstring>
+#include <set>
+#include <cctype>
 #include "vroom/asset/PackageFormat.hpp"
 
 namespace fs = std::filesystem;
 
-int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_directory> <output_package>" << std::endl;
-        return 1;
-    }
+namespace {
 
-    fs::path inputDir = argv[1];
-    fs::path outputFile = argv[2];
+struct InputFile {
+    fs::path sourcePath;
+    std::string relativePath; // Always uses '/' separators
+    uint64_t pathHash = 0;
+    bool compress = false;
+};
 
-    if (!fs::exists(inputDir) || !fs::is_directory(inputDir)) {
-        std::cerr << "Error: Input directory does not exist or is not a directory." << std::endl;
-        return 1;
-    }
+// A compressed entry is only kept if it saves at least 1/16 of the original size;
+// smaller gains aren't worth the decompression cost at load time.
+size_t maxCompressedSize(size_t rawSize) {
+    return rawSize - rawSize / 16;
+}
 
-    std::vector<std::pair<fs::path, std::string>> files;
-    for (const auto& entry : fs::recursive_directory_iterator(inputDir)) {
-        if (entry.is_regular_file()) {
-            fs::path relativePath = fs::relative(entry.path(), inputDir);
-            if (relativePath.string().length() >= 256) {
-                std::cerr << "Warning: Skipping file with path too long: " << relativePath.string() << std::endl;
-                continue;
-            }
-            files.push_back({entry.path(), relativePath.string()});
-        }
+bool shouldCompress(const fs::path& path, const std::set<std::string>& extensions) {
+    if (extensions.count("*")) {
+        return true;
     }
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extensions.count(ext) > 0;
+}
 
-    std::ofstream out(outputFile, std::ios::binary);
-    if (!out.is_open()) {
-        std::cerr << "Error: Failed to open output file." << std::endl;
-        return 1;
+bool readWholeFile(const fs::path& path, std::vector<char>& buffer) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return false;
     }
+    auto size = in.tellg();
+    buffer.resize(static_cast<size_t>(size));
+    in.seekg(0, std::ios::beg);
+    return size == 0 || static_cast<bool>(in.read(buffer.data(), size));
+}
+
+void writePadding(std::ofstream& out, uint64_t& position, uint64_t alignment) {
+    static const char zeros[vroom::PACKAGE_DATA_ALIGNMENT] = {};
+    uint64_t aligned = vroom::alignPackageOffset(position, alignment);
+    out.write(zeros, static_cast<std::streamsize>(aligned - position));
+    position = aligned;
+}
 
+int writeVersion1(const std::vector<InputFile>& files, std::ofstream& out) {
     // Prepare header
     vroom::PackageHeader header;
+    header.version = vroom::PACKAGE_VERSION_1;
     header.fileCount = static_cast<uint32_t>(files.size());
-    
+
     // Calculate offsets
     std::vector<vroom::PackageFileEntry> entries;
     uint64_t currentOffset = sizeof(vroom::PackageHeader) + (files.size() * sizeof(vroom::PackageFileEntry));
 
-    for (const auto& [path, relativePath] : files) {
+    for (const auto& file : files) {
         vroom::PackageFileEntry entry;
         std::memset(entry.path, 0, sizeof(entry.path));
-        std::strncpy(entry.path, relativePath.c_str(), sizeof(entry.path) - 1);
+        std::strncpy(entry.path, file.relativePath.c_str(), sizeof(entry.path) - 1);
         entry.offset = currentOffset;
-        entry.size = fs::file_size(path);
-        
+        entry.size = fs::file_size(file.sourcePath);
+
         entries.push_back(entry);
         currentOffset += entry.size;
     }
@@ -68,13 +83,186 @@ int main(int argc, char* argv[]) {
     }
 
     // Write file contents
-    for (const auto& [path, relativePath] : files) {
-        std::ifstream in(path, std::ios::binary);
+    for (const auto& file : files) {
+        std::ifstream in(file.sourcePath, std::ios::binary);
         out << in.rdbuf();
     }
 
-    std::cout << "Package created successfully: " << outputFile << " (" << files.size() << " files)" << std::endl;
-
     return 0;
 }
 
+int writeVersion2(std::vector<InputFile> files, std::ofstream& out) {
+    // The reader binary-searches the table, so it must be sorted by (hash, path)
+    std::sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b) {
+        if (a.pathHash != b.pathHash) {
+            return a.pathHash < b.pathHash;
+        }
+        return a.relativePath < b.relativePath;
+    });
+
+    vroom::PackageHeaderV2 header;
+    header.fileCount = static_cast<uint32_t>(files.size());
+    header.tocOffset = vroom::alignPackageOffset(sizeof(vroom::PackageHeaderV2), alignof(vroom::PackageTocEntry));
+
+    std::vector<vroom::PackageTocEntry> toc(files.size());
+    std::string strings;
+    for (size_t i = 0; i < files.size(); ++i) {
+        toc[i].pathHash = files[i].pathHash;
+        toc[i].pathOffset = static_cast<uint32_t>(strings.size());
+        toc[i].pathLength = static_cast<uint32_t>(files[i].relativePath.size());
+        strings += files[i].relativePath;
+    }
+
+    header.stringTableOffset = header.tocOffset + toc.size() * sizeof(vroom::PackageTocEntry);
+    header.stringTableSize = strings.size();
+
+    // Write header, a placeholder table (patched once offsets and checksums are known) and strings
+    uint64_t position = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    position += sizeof(header);
+    writePadding(out, position, alignof(vroom::PackageTocEntry));
+    out.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(vroom::PackageTocEntry)));
+    position += toc.size() * sizeof(vroom::PackageTocEntry);
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    position += strings.size();
+
+    // Write file contents, each starting on an aligned offset
+    std::vector<char> buffer;
+    std::vector<char> compressed;
+    uint64_t rawTotal = 0;
+    uint64_t storedTotal = 0;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!readWholeFile(files[i].sourcePath, buffer)) {
+            std::cerr << "Error: Failed to read input file: " << files[i].sourcePath << std::endl;
+            return 1;
+        }
+
+        const std::vector<char>* stored = &buffer;
+        toc[i].codec = vroom::PackageCodec::None;
+        if (files[i].compress && !buffer.empty()) {
+            // Capping the output at the worthwhile size makes incompressible files bail out early
+            compressed.resize(maxCompressedSize(buffer.size()));
+            size_t compressedSize = vroom::lz4Compress(buffer.data(), buffer.size(), compressed.data(), compressed.size());
+            if (compressedSize > 0) {
+                compressed.resize(compressedSize);
+                stored = &compressed;
+                toc[i].codec = vroom::PackageCodec::LZ4;
+            }
+        }
+
+        writePadding(out, position, header.dataAlignment);
+        toc[i].offset = position;
+        toc[i].storedSize = stored->size();
+        toc[i].size = buffer.size();
+        toc[i].checksum = vroom::hashPackageData(stored->data(), stored->size());
+
+        out.write(stored->data(), static_cast<std::streamsize>(stored->size()));
+        position += stored->size();
+        rawTotal += buffer.size();
+        storedTotal += stored->size();
+    }
+
+    if (storedTotal != rawTotal) {
+        std::cout << "Compressed " << rawTotal << " bytes of file data to " << storedTotal << " bytes" << std::endl;
+    }
+
+    out.seekp(static_cast<std::streamoff>(header.tocOffset), std::ios::beg);
+    out.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(vroom::PackageTocEntry)));
+
+    return out ? 0 : 1;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--format-version <1|2>] [--compress <ext>[,<ext>...]] <input_directory> <output_package>" << std::endl;
+    std::cerr << "  --compress  LZ4-compress files with the given extensions (e.g. .json,.txt), or '*' for all files." << std::endl;
+    std::cerr << "              Files that don't compress are stored raw. Requires format version 2." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t formatVersion = vroom::PACKAGE_VERSION_2;
+    std::set<std::string> compressExtensions;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format-version" && i + 1 < argc) {
+            formatVersion = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--compress" && i + 1 < argc) {
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t end = list.find(',', start);
+                if (end == std::string::npos) {
+                    end = list.size();
+                }
+                std::string ext = list.substr(start, end - start);
+                if (!ext.empty()) {
+                    if (ext != "*" && ext[0] != '.') {
+                        ext = "." + ext;
+                    }
+                    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                    compressExtensions.insert(ext);
+                }
+                start = end + 1;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.size() != 2 ||
+        (formatVersion != vroom::PACKAGE_VERSION_1 && formatVersion != vroom::PACKAGE_VERSION_2)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (formatVersion == vroom::PACKAGE_VERSION_1 && !compressExtensions.empty()) {
+        std::cerr << "Error: Compression requires package format version 2." << std::endl;
+        return 1;
+    }
+
+    fs::path inputDir = positional[0];
+    fs::path outputFile = positional[1];
+
+    if (!fs::exists(inputDir) || !fs::is_directory(inputDir)) {
+        std::cerr << "Error: Input directory does not exist or is not a directory." << std::endl;
+        return 1;
+    }
+
+    std::vector<InputFile> files;
+    for (const auto& entry : fs::recursive_directory_iterator(inputDir)) {
+        if (entry.is_regular_file()) {
+            fs::path relativePath = fs::relative(entry.path(), inputDir);
+            if (formatVersion == vroom::PACKAGE_VERSION_1 && relativePath.string().length() >= 256) {
+                std::cerr << "Warning: Skipping file with path too long: " << relativePath.string() << std::endl;
+                continue;
+            }
+            std::string genericPath = relativePath.generic_string();
+            files.push_back({entry.path(), genericPath, vroom::hashPackagePath(genericPath),
+                             shouldCompress(relativePath, compressExtensions)});
+        }
+    }
+
+    std::ofstream out(outputFile, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Error: Failed to open output file." << std::endl;
+        return 1;
+    }
+
+    size_t fileCount = files.size();
+    int result = formatVersion == vroom::PACKAGE_VERSION_1
+        ? writeVersion1(files, out)
+        : writeVersion2(std::move(files), out);
+
+    if (result != 0) {
+        std::cerr << "Error: Failed to write package: " << outputFile << std::endl;
+        return result;
+    }
+
+    std::cout << "Package created successfully: " << outputFile << " (v" << formatVersion << ", "
+              << fileCount << " files)" << std::endl;
+
+    return 0;
+}